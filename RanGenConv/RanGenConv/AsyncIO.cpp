@@ -0,0 +1,443 @@
+//
+//  AsyncIO.cpp
+//  RanGenConv
+//
+
+#include "AsyncIO.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(WIN32) || defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef RANGENCONV_HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+// largest number of bytes transferred by one read / write call
+#define MAX_TRANSFER (1 << 30)
+
+/**
+ * @brief opens file for reading
+ * @return descriptor or -1 if file could not be opened, size is set to the size of the file
+ */
+static int open_input(const std::string& path, unsigned long long& size) {
+#if defined(WIN32) || defined(_WIN32)
+    int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+    struct _stat64 st;
+    if(fd >= 0 && _fstat64(fd, &st) != 0) {
+        _close(fd);
+        return -1;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if(fd >= 0 && fstat(fd, &st) != 0) {
+        ::close(fd);
+        return -1;
+    }
+#endif
+    size = fd >= 0 ? (unsigned long long)st.st_size : 0;
+    return fd;
+}
+
+static void close_input(const int fd) {
+#if defined(WIN32) || defined(_WIN32)
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+#ifdef RANGENCONV_HAVE_IO_URING
+/**
+ * @brief submission and completion queue of an io_uring instance mapped into user space
+ * @details set up via the raw system calls, i.e. without liburing
+ */
+class IoRing {
+public:
+    int                     fd;
+    void                   *sq_ptr;
+    size_t                  sq_size;
+    void                   *cq_ptr;
+    size_t                  cq_size;
+    struct io_uring_sqe    *sqes;
+    size_t                  sqes_size;
+    unsigned               *sq_head;
+    unsigned               *sq_tail;
+    unsigned               *sq_mask;
+    unsigned               *sq_array;
+    unsigned               *cq_head;
+    unsigned               *cq_tail;
+    unsigned               *cq_mask;
+    struct io_uring_cqe    *cqes;
+    unsigned                entries;
+
+    IoRing() : fd(-1), sq_ptr(MAP_FAILED), sq_size(0), cq_ptr(MAP_FAILED), cq_size(0), sqes((struct io_uring_sqe *)MAP_FAILED), sqes_size(0) {}
+
+    ~IoRing() {
+        if(sqes != MAP_FAILED)munmap(sqes, sqes_size);
+        if(cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)munmap(cq_ptr, cq_size);
+        if(sq_ptr != MAP_FAILED)munmap(sq_ptr, sq_size);
+        if(fd >= 0)::close(fd);
+    }
+
+    /**
+     * @return false if io_uring is not supported or not permitted
+     */
+    bool setup(const unsigned depth) {
+        struct io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        fd = (int)syscall(__NR_io_uring_setup, depth, &p);
+        if(fd < 0)return false;
+
+        sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        if(p.features & IORING_FEAT_SINGLE_MMAP)sq_size = cq_size = std::max(sq_size, cq_size);
+        sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if(sq_ptr == MAP_FAILED)return false;
+        cq_ptr = p.features & IORING_FEAT_SINGLE_MMAP ? sq_ptr : mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(cq_ptr == MAP_FAILED)return false;
+        sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+        sqes = (struct io_uring_sqe *)mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if(sqes == MAP_FAILED)return false;
+
+        char *sq = (char *)sq_ptr, *cq = (char *)cq_ptr;
+        sq_head = (unsigned *)(sq + p.sq_off.head);
+        sq_tail = (unsigned *)(sq + p.sq_off.tail);
+        sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+        sq_array = (unsigned *)(sq + p.sq_off.array);
+        cq_head = (unsigned *)(cq + p.cq_off.head);
+        cq_tail = (unsigned *)(cq + p.cq_off.tail);
+        cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+        entries = std::min(p.sq_entries, p.cq_entries);
+        return true;
+    }
+
+    /**
+     * @brief queues transfer of the remaining bytes of r, requires a free submission entry
+     */
+    void prepare(AsyncIORequest& r) {
+        const unsigned tail = *sq_tail;
+        const unsigned index = tail & *sq_mask;
+        struct io_uring_sqe *sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        r.iov.iov_base = r.data + r.transferred;
+        r.iov.iov_len = std::min(r.length - r.transferred, (size_t)MAX_TRANSFER);
+        sqe->opcode = r.write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = r.fd;
+        sqe->addr = (unsigned long long)&r.iov;
+        sqe->len = 1;
+        sqe->off = r.offset + r.transferred;
+        sqe->user_data = (unsigned long long)&r;
+        sq_array[index] = index;
+        // entry has to be visible to the kernel before the tail
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief submits prepared entries and waits for min_complete completions
+     * @return false if the ring failed
+     */
+    bool enter(const unsigned to_submit, const unsigned min_complete) {
+        for(;;) {
+            int res = (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+            if(res >= 0)return true;
+            // interrupted or out of kernel resources for the moment
+            if(errno == EINTR || errno == EAGAIN || errno == EBUSY)continue;
+            return false;
+        }
+    }
+};
+#endif
+
+AsyncIO::~AsyncIO() {
+    stop();
+}
+
+/**
+ * @brief starts the I/O thread
+ *
+ * @param depth maximum number of requests in flight if io_uring is used
+ * @return false if the thread is running already
+ */
+bool AsyncIO::start(const unsigned int depth) {
+    if(_running)return false;
+
+    _depth = std::max(depth, 1u);
+#ifdef RANGENCONV_HAVE_IO_URING
+    IoRing *ring = new IoRing();
+    if(ring->setup(_depth)) {
+        _depth = std::min(_depth, ring->entries);
+        _ring = ring;
+    }
+    else delete ring;
+#endif
+
+    _stop = false;
+    _running = true;
+    _thread = std::thread(&AsyncIO::run, this);
+    return true;
+}
+
+/**
+ * @brief carries out all requests submitted so far and stops the I/O thread
+ */
+void AsyncIO::stop() {
+    if(!_running)return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _submitted.notify_all();
+    _thread.join();
+    _running = false;
+#ifdef RANGENCONV_HAVE_IO_URING
+    delete (IoRing *)_ring;
+#endif
+    _ring = NULL;
+}
+
+/**
+ * @brief queues a request, which is carried out asynchronously
+ */
+void AsyncIO::submit(AsyncIORequest& r) {
+    r.transferred = 0;
+    r.finished = false;
+    r.ok = true;
+    if(r.length == 0 || !_running) {
+        // nothing to transfer or no thread to do it
+        finish(r, r.length == 0 || transfer(r));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(&r);
+    }
+    _submitted.notify_one();
+}
+
+/**
+ * @brief waits until a request is finished
+ * @return true if all bytes were transferred
+ */
+bool AsyncIO::wait(AsyncIORequest& r) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _completed.wait(lock, [&r]() {return r.finished;});
+    return r.ok;
+}
+
+void AsyncIO::finish(AsyncIORequest& r, const bool ok) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        r.ok = ok;
+        r.finished = true;
+    }
+    _completed.notify_all();
+}
+
+/**
+ * @brief transfers the remaining bytes of r synchronously
+ * @return false if an error occured or a read hit the end of the file early
+ */
+bool AsyncIO::transfer(AsyncIORequest& r) {
+    while(r.transferred < r.length) {
+        const size_t n = std::min(r.length - r.transferred, (size_t)MAX_TRANSFER);
+#if defined(WIN32) || defined(_WIN32)
+        // the I/O thread is the only user of the descriptor
+        if(_lseeki64(r.fd, r.offset + r.transferred, SEEK_SET) < 0)return false;
+        int res = r.write ? _write(r.fd, r.data + r.transferred, (unsigned int)n) : _read(r.fd, r.data + r.transferred, (unsigned int)n);
+#else
+        ssize_t res = r.write ? pwrite(r.fd, r.data + r.transferred, n, (off_t)(r.offset + r.transferred)) : pread(r.fd, r.data + r.transferred, n, (off_t)(r.offset + r.transferred));
+        if(res < 0 && errno == EINTR)continue;
+#endif
+        if(res <= 0)return false;
+        r.transferred += (size_t)res;
+    }
+    return true;
+}
+
+/**
+ * @brief body of the I/O thread
+ */
+void AsyncIO::run() {
+    // requests left by a failed ring are transferred by the thread
+    if(_ring && run_ring())return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for(;;) {
+        _submitted.wait(lock, [this]() {return !_queue.empty() || _stop;});
+        if(_queue.empty())break;
+        AsyncIORequest *r = _queue.front();
+        _queue.pop_front();
+        lock.unlock();
+        const bool ok = transfer(*r);
+        finish(*r, ok);
+        lock.lock();
+    }
+}
+
+/**
+ * @brief body of the I/O thread if io_uring is used
+ * @details keeps up to _depth requests in flight. Partial transfers are resubmitted for the remaining bytes.
+ * @return false if the ring failed, requests in flight are finished as failed then
+ */
+bool AsyncIO::run_ring() {
+#ifdef RANGENCONV_HAVE_IO_URING
+    IoRing& ring = *(IoRing *)_ring;
+    std::deque<AsyncIORequest *> resubmit;
+    std::vector<AsyncIORequest *> in_flight;
+
+    for(;;) {
+        // move requests to the submission queue
+        unsigned prepared = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if(in_flight.empty() && resubmit.empty())_submitted.wait(lock, [this]() {return !_queue.empty() || _stop;});
+            if(in_flight.empty() && resubmit.empty() && _queue.empty())break;
+            while(in_flight.size() < _depth && (!resubmit.empty() || !_queue.empty())) {
+                std::deque<AsyncIORequest *>& q = resubmit.empty() ? _queue : resubmit;
+                ring.prepare(*q.front());
+                in_flight.push_back(q.front());
+                q.pop_front();
+                prepared++;
+            }
+        }
+
+        if(!ring.enter(prepared, 1)) {
+            for(size_t i = 0; i < in_flight.size(); i++)finish(*in_flight[i], false);
+            for(size_t i = 0; i < resubmit.size(); i++)finish(*resubmit[i], false);
+            return false;
+        }
+
+        // reap completions
+        unsigned head = *ring.cq_head;
+        while(head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+            AsyncIORequest& r = *(AsyncIORequest *)cqe->user_data;
+            const int res = cqe->res;
+            head++;
+            in_flight.erase(std::find(in_flight.begin(), in_flight.end(), &r));
+            if(res <= 0) {
+                finish(r, false);
+                continue;
+            }
+            r.transferred += (size_t)res;
+            if(r.transferred < r.length)resubmit.push_back(&r);
+            else finish(r, true);
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief reads a whole file into contents
+ * @return false if the file could not be read
+ */
+bool read_file(const std::string& path, std::string& contents) {
+    std::ifstream ifs(path.c_str(), std::ios::in | std::ios::binary);
+    if(!ifs)return false;
+    std::ostringstream ss;
+    ss << ifs.rdbuf();
+    contents = ss.str();
+    return !ifs.bad();
+}
+
+/**
+ * @brief starts reading the first files
+ *
+ * @param io I/O thread carrying out the reads
+ * @param files paths of the files
+ * @param order indices of files in the order they are expected to be taken
+ * @param ahead maximum number of files read but not taken
+ * @param max_bytes maximum number of bytes read but not taken
+ */
+InputPrefetcher::InputPrefetcher(AsyncIO& io, const std::vector<std::string>& files, const std::vector<size_t>& order, const size_t ahead, const unsigned long long max_bytes):
+_io(io), _files(files), _order(order), _entries(files.size()), _next(0), _loaded(0), _loaded_bytes(0), _ahead(std::max(ahead, (size_t)1)), _max_bytes(max_bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    refill();
+}
+
+InputPrefetcher::~InputPrefetcher() {
+    // reads in flight write to the entries
+    for(std::vector<Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        if(it->request.fd < 0)continue;
+        _io.wait(it->request);
+        close_input(it->request.fd);
+    }
+}
+
+/**
+ * @brief schedules reads until ahead files or max_bytes bytes are loaded, requires _mutex to be held
+ */
+void InputPrefetcher::refill() {
+    while(_next < _order.size() && (_loaded == 0 || (_loaded < _ahead && _loaded_bytes < _max_bytes))) {
+        Entry& e = _entries[_order[_next++]];
+        if(e.scheduled)continue; // taken before its turn
+        e.scheduled = true;
+        _loaded++;
+
+        unsigned long long size = 0;
+        int fd = open_input(_files[_order[_next - 1]], size);
+        if(fd < 0) {
+            e.failed = true;
+            continue;
+        }
+        e.contents.resize((size_t)size);
+        e.request.fd = fd;
+        e.request.write = false;
+        e.request.data = size > 0 ? &e.contents[0] : NULL;
+        e.request.length = (size_t)size;
+        e.request.offset = 0;
+        _loaded_bytes += size;
+        _io.submit(e.request);
+    }
+}
+
+/**
+ * @brief hands out the contents of a file, each file may be taken once
+ *
+ * @param index index of the file
+ * @param contents set to the contents of the file
+ * @return false if the file could not be read
+ */
+bool InputPrefetcher::take(const size_t index, std::string& contents) {
+    Entry& e = _entries[index];
+    bool direct;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        direct = !e.scheduled;
+        e.scheduled = true;
+    }
+    if(direct)return read_file(_files[index], contents);
+
+    const bool ok = !e.failed && _io.wait(e.request);
+    if(e.request.fd >= 0) {
+        close_input(e.request.fd);
+        e.request.fd = -1;
+    }
+    contents.swap(e.contents);
+    std::string().swap(e.contents);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loaded--;
+    _loaded_bytes -= e.request.length;
+    refill();
+    return ok;
+}
@@ -0,0 +1,119 @@
+//
+//  AsyncIO.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_AsyncIO_h
+#define RanGenConv_AsyncIO_h
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// io_uring is used if RANGENCONV_HAVE_IO_URING is defined (Linux >= 5.1, needs <linux/io_uring.h> only) and the kernel
+// permits it, otherwise reads and writes are carried out by the I/O thread itself via pread / pwrite
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <sys/uio.h>
+#endif
+
+/**
+ * @brief read or write of a byte range of a file, executed by AsyncIO
+ * @details data has to stay valid until the request is finished. The request may be reused once AsyncIO::wait returned.
+ */
+class AsyncIORequest {
+public:
+    int                     fd;
+    bool                    write;              /**< true to write data, false to read into data */
+    char                   *data;
+    size_t                  length;             /**< number of bytes to transfer */
+    unsigned long long      offset;             /**< position in the file */
+    size_t                  transferred;        /**< bytes transferred so far, updated by the I/O thread */
+    bool                    finished;
+    bool                    ok;                 /**< true if all bytes were transferred */
+    std::vector<char>       buffer;             /**< storage for data if owned by the request, e.g. a buffer of an OutputSink */
+#if !defined(WIN32) && !defined(_WIN32)
+    struct iovec            iov;                /**< used by io_uring */
+#endif
+
+    AsyncIORequest() : fd(-1), write(false), data(NULL), length(0), offset(0), transferred(0), finished(true), ok(true) {}
+};
+
+/**
+ * @brief executes file reads and writes on a thread of its own, so that I/O overlaps with computation
+ * @details requests are queued via submit and carried out in order of submission, completion is awaited via wait. With io_uring up to depth requests are in flight at once, i.e. the disk sees several requests even though a single thread drives them. Without io_uring the thread transfers one request after another.
+ */
+class AsyncIO {
+private:
+    std::thread             _thread;
+    std::mutex              _mutex;
+    std::condition_variable _submitted;
+    std::condition_variable _completed;
+    std::deque<AsyncIORequest *> _queue;        /**< requests not handed to the kernel yet */
+    bool                    _running;
+    bool                    _stop;
+    unsigned int            _depth;
+    void                   *_ring;              /**< io_uring state, NULL if requests are transferred by the thread */
+
+    void                    run();
+    bool                    run_ring();
+    void                    finish(AsyncIORequest& r, const bool ok);
+    bool                    transfer(AsyncIORequest& r);
+
+    // not copyable
+    AsyncIO(const AsyncIO& other);
+    AsyncIO& operator = (const AsyncIO& other);
+
+public:
+    AsyncIO():_running(false), _stop(false), _depth(0), _ring(NULL) {}
+    ~AsyncIO();
+
+    bool                    start(const unsigned int depth = 64);
+    void                    stop();
+    void                    submit(AsyncIORequest& r);
+    bool                    wait(AsyncIORequest& r);
+    const char             *backend() const {return _ring ? "io_uring" : "thread";}
+};
+
+/**
+ * @brief reads whole files ahead of their use via AsyncIO
+ * @details files are read in the given order, while at most ahead files and max_bytes bytes are loaded but not taken yet (at least one file is always read ahead). take hands out the contents of a file, waiting if it is still being read and reading it directly if it was not scheduled yet, hence files may be taken in any order.
+ */
+class InputPrefetcher {
+private:
+    class Entry {
+    public:
+        AsyncIORequest      request;
+        std::string         contents;
+        bool                scheduled;          /**< read was submitted or the file was taken */
+        bool                failed;             /**< file could not be opened */
+
+        Entry() : scheduled(false), failed(false) {}
+    };
+
+    AsyncIO&                _io;
+    const std::vector<std::string>& _files;
+    std::vector<size_t>     _order;
+    std::vector<Entry>      _entries;
+    size_t                  _next;              /**< position in _order of the next file to schedule */
+    size_t                  _loaded;            /**< files scheduled but not taken */
+    unsigned long long      _loaded_bytes;
+    size_t                  _ahead;
+    unsigned long long      _max_bytes;
+    std::mutex              _mutex;
+
+    void                    refill();
+
+public:
+    InputPrefetcher(AsyncIO& io, const std::vector<std::string>& files, const std::vector<size_t>& order, const size_t ahead, const unsigned long long max_bytes);
+    ~InputPrefetcher();
+
+    bool                    take(const size_t index, std::string& contents);
+};
+
+bool                        read_file(const std::string& path, std::string& contents);
+
+#endif
@@ -0,0 +1,251 @@
+//
+//  Batch.cpp
+//  RanGenConv
+//
+
+#include "Batch.h"
+#include "Metrics.h"
+#include "AsyncIO.h"
+#include "Manifest.h"
+
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <exception>
+
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <glob.h>
+#include <sys/stat.h>
+#endif
+
+// bytes of inputs read ahead at most
+#define BATCH_PREFETCH_BYTES (1ULL << 28)
+
+/**
+ * @return size of file path in bytes, 0 if it cannot be determined
+ */
+static unsigned long long file_size(const std::string& path) {
+#if defined(WIN32) || defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if(!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))return 0;
+    return ((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+#else
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (unsigned long long)st.st_size : 0;
+#endif
+}
+
+/**
+ * @return true if path is an existing directory
+ */
+bool is_directory(const std::string& path) {
+#if defined(WIN32) || defined(_WIN32)
+    DWORD attr = GetFileAttributesA(path.c_str());
+    return attr != INVALID_FILE_ATTRIBUTES && (attr & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+/**
+ * @brief lists the instances matched by a file, directory or glob pattern
+ * @details patterns containing *, ? or [ are expanded by the program itself, which allows to pass more files than fit on a commandline when quoted. Matched directories contribute their .rcp files as in metrics mode.
+ *
+ * @param pattern file, directory or glob pattern
+ * @param files instances are appended to files
+ * @return false if pattern does not match anything
+ */
+bool expand_instances(const std::string& pattern, std::vector<std::string>& files) {
+    using namespace std;
+
+    if(pattern.find_first_of("*?[") == string::npos)return list_instances(pattern, files);
+
+    vector<string> matches;
+#if defined(WIN32) || defined(_WIN32)
+    // wildcards are supported in the last component only
+    size_t slash = pattern.find_last_of("/\\");
+    string directory = slash == string::npos ? "" : pattern.substr(0, slash + 1);
+    WIN32_FIND_DATAA data;
+    HANDLE h = FindFirstFileA(pattern.c_str(), &data);
+    if(h == INVALID_HANDLE_VALUE)return false;
+    do {
+        string name = data.cFileName;
+        if(name != "." && name != "..")matches.push_back(directory + name);
+    } while(FindNextFileA(h, &data));
+    FindClose(h);
+    sort(matches.begin(), matches.end());
+#else
+    glob_t g;
+    if(glob(pattern.c_str(), 0, NULL, &g) != 0) {
+        globfree(&g);
+        return false;
+    }
+    for(size_t i = 0; i < g.gl_pathc; i++)matches.push_back(g.gl_pathv[i]);
+    globfree(&g);
+#endif
+
+    for(vector<string>::const_iterator it = matches.begin(); it != matches.end(); ++it)
+        if(!list_instances(*it, files))return false;
+    return true;
+}
+
+/**
+ * @brief assigns output file and seed to each instance of a batch
+ * @details the output file is named after the instance with its extension replaced by extension. Each instance uses seed plus a hash of its file name, so each instance draws from a random stream of its own and the result neither depends on the number of threads, on which worker converts it nor on the other instances of the batch. Hence adding instances to a corpus leaves the seeds of the others unchanged (see Manifest). A single instance can be reproduced via -S with the seed reported.
+ *
+ * @param files paths of the instances
+ * @param directory output directory
+ * @param extension extension of the output files including the dot
+ * @param seed base seed
+ * @param results filled with one entry per file
+ * @return false if two instances would be written to the same output file
+ */
+bool batch_outputs(const std::vector<std::string>& files, const std::string& directory, const std::string& extension, const unsigned int seed, std::vector<BatchResult>& results) {
+    using namespace std;
+
+    results.assign(files.size(), BatchResult());
+    set<string> outputs;
+    for(size_t i = 0; i < files.size(); i++) {
+        const string filename = files[i].substr(files[i].find_last_of("/\\") + 1);
+        const string name = filename.substr(0, filename.find_last_of('.'));
+        results[i].input = files[i];
+        results[i].output = directory + "/" + name + extension;
+        results[i].seed = seed + (unsigned int)fnv1a(filename.data(), filename.size());
+        if(!outputs.insert(results[i].output).second) {
+            cout<<"error: "<<files[i]<<" would overwrite output "<<results[i].output<<" of another instance"<<endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief deque of work items of one worker
+ */
+class WorkQueue {
+public:
+    std::mutex              mutex;
+    std::deque<size_t>      items;
+
+    /**
+     * @brief removes an item from the front (owner) or the back (thief)
+     * @return false if the queue is empty
+     */
+    bool pop(size_t& item, const bool front) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(items.empty())return false;
+        if(front) {
+            item = items.front();
+            items.pop_front();
+        }
+        else {
+            item = items.back();
+            items.pop_back();
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief indices of the items sorted by decreasing cost, ties keep their order
+ */
+static std::vector<size_t> cost_order(const std::vector<unsigned long long>& costs) {
+    std::vector<size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), (size_t)0);
+    std::stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) {return costs[a] > costs[b];});
+    return order;
+}
+
+/**
+ * @brief calls func(item, worker) for each item on a pool of threads balancing items of very different cost
+ * @details items are sorted by decreasing cost and dealt round robin to the workers' queues. Each worker processes its own queue from the front, i.e. the largest items first, and once it runs dry steals from the back of the other queues, which hold the smallest items left. Hence huge items start early, while the tail of tiny items fills the gaps at the end. No items are added during the run, so a worker stops once all queues are empty.
+ *
+ * @param costs estimated cost of each item, e.g. its file size
+ * @param threads number of worker threads
+ * @param func called once per item with the item's index and the number of the worker
+ */
+void work_stealing_for(const std::vector<unsigned long long>& costs, const int threads, const std::function<void(size_t, int)>& func) {
+    using namespace std;
+
+    const size_t count = costs.size();
+    const int num_threads = max(min(threads, (int)count), 1);
+
+    const vector<size_t> order = cost_order(costs);
+
+    vector<WorkQueue> queues(num_threads);
+    for(size_t i = 0; i < count; i++)queues[i % num_threads].items.push_back(order[i]);
+
+    auto work = [&](const int w) {
+        size_t item;
+        for(;;) {
+            bool found = queues[w].pop(item, true);
+            for(int k = 1; !found && k < num_threads; k++)found = queues[(w + k) % num_threads].pop(item, false);
+            if(!found)break;
+            func(item, w);
+        }
+    };
+
+    vector<thread> workers;
+    for(int t = 1; t < num_threads; t++)workers.push_back(thread(work, t));
+    work(0);
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+}
+
+/**
+ * @brief converts the instances of a batch in a pipeline of read, convert and write stages
+ * @details with io set, inputs are read ahead by the I/O thread in the order the workers are expected to take them, while at most 2 x threads files or BATCH_PREFETCH_BYTES bytes wait in memory. The workers parse, generate and format instances on a work stealing pool (see work_stealing_for), output files written behind by the I/O thread if convert sets up its sinks accordingly. Hence reading, converting and writing of different instances overlap. Without io, convert reads the instance itself. A failing instance is reported and leaves the others unaffected, this includes exceptions thrown by convert, e.g. std::bad_alloc for an instance too large for memory. One line is printed per instance once it is done.
+ *
+ * @param results instances as set up by batch_outputs, ok, worker and seconds are filled in
+ * @param threads number of worker threads
+ * @param io I/O thread to read inputs ahead, NULL to read them on the workers
+ * @param convert converts one instance given its contents (NULL if not read ahead), returns false or throws on failure. Called concurrently.
+ */
+void run_batch(std::vector<BatchResult>& results, const int threads, AsyncIO *io, const std::function<bool(BatchResult&, const std::string *)>& convert) {
+    using namespace std;
+
+    vector<unsigned long long> costs(results.size());
+    vector<string> inputs(results.size());
+    for(size_t i = 0; i < results.size(); i++) {
+        costs[i] = file_size(results[i].input);
+        inputs[i] = results[i].input;
+    }
+
+    InputPrefetcher *prefetcher = io ? new InputPrefetcher(*io, inputs, cost_order(costs), 2 * (size_t)max(threads, 1), BATCH_PREFETCH_BYTES) : NULL;
+
+    mutex print;
+    work_stealing_for(costs, threads, [&](size_t i, int worker) {
+        BatchResult& r = results[i];
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        string contents;
+        bool read = true;
+        if(prefetcher && !(read = prefetcher->take(i, contents))) {
+            lock_guard<mutex> lock(print);
+            cout<<"error: "<<r.input<<" could not be read"<<endl;
+        }
+        try {
+            r.ok = read && convert(r, prefetcher ? &contents : NULL);
+        }
+        catch(const exception& e) {
+            r.ok = false;
+            r.error = e.what();
+        }
+        r.worker = worker;
+        r.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        lock_guard<mutex> lock(print);
+        if(r.ok && r.skipped)cout<<"unchanged "<<r.input<<" -> "<<r.output<<endl;
+        else if(r.ok)cout<<"ok "<<r.input<<" -> "<<r.output<<" (seed "<<r.seed<<", "<<r.seconds<<"s)"<<endl;
+        else if(!r.error.empty())cout<<"failed "<<r.input<<" (seed "<<r.seed<<"): "<<r.error<<endl;
+        else cout<<"failed "<<r.input<<" (seed "<<r.seed<<")"<<endl;
+    });
+
+    delete prefetcher;
+}
@@ -0,0 +1,38 @@
+//
+//  Batch.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Batch_h
+#define RanGenConv_Batch_h
+
+#include <string>
+#include <vector>
+#include <functional>
+
+class AsyncIO;
+
+/**
+ * @brief outcome of converting one instance of a batch
+ */
+class BatchResult {
+public:
+    std::string             input;              /**< path of the instance */
+    std::string             output;             /**< path of the output file */
+    unsigned int            seed;               /**< seed the times were generated with */
+    bool                    ok;                 /**< true if the instance was converted */
+    bool                    skipped;            /**< true if the output was up to date */
+    int                     worker;             /**< worker thread which converted the instance */
+    double                  seconds;            /**< wall time of the conversion */
+    std::string             error;              /**< message of the exception the conversion failed with, empty if none */
+
+    BatchResult() : seed(0), ok(false), skipped(false), worker(-1), seconds(0.0) {}
+};
+
+bool                        is_directory(const std::string& path);
+bool                        expand_instances(const std::string& pattern, std::vector<std::string>& files);
+bool                        batch_outputs(const std::vector<std::string>& files, const std::string& directory, const std::string& extension, const unsigned int seed, std::vector<BatchResult>& results);
+void                        work_stealing_for(const std::vector<unsigned long long>& costs, const int threads, const std::function<void(size_t, int)>& func);
+void                        run_batch(std::vector<BatchResult>& results, const int threads, AsyncIO *io, const std::function<bool(BatchResult&, const std::string *)>& convert);
+
+#endif
@@ -0,0 +1,320 @@
+//
+//  BinaryFormat.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_BinaryFormat_h
+#define RanGenConv_BinaryFormat_h
+
+// header-only reader of the binary instance format written by RanGenConv -B.
+// Does not depend on any other file of RanGenConv, copy it to your solver's code base.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(WIN32) || defined(_WIN32)
+// keep windows.h from defining min / max macros, which break std::min / std::max in code including this file
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define RGC_BINARY_MAGIC "RGCBIN\0\0"
+#define RGC_BINARY_VERSION 1
+#define RGC_BINARY_ALIGNMENT 64
+#define RGC_BINARY_ENDIAN_MARK 0x01020304u
+
+#define RGC_BINARY_FLAG_DUMMYNODES 0x1  /**< activities include dummy start and end */
+
+/**
+ * @brief sections of a binary instance, all arrays are stored in native byte order
+ */
+enum BinarySection {
+    SECTION_DURATION = 0,               /**< int32[activities], duration of each activity */
+    SECTION_RELEASE,                    /**< int32[activities], release of each activity */
+    SECTION_DEADLINE,                   /**< int32[activities], deadline of each activity */
+    SECTION_CAPACITY,                   /**< int32[resources], constant capacity of each resource */
+    SECTION_DEMAND,                     /**< int32[activities x resources], demands row by row */
+    SECTION_SUCC_OFFSET,                /**< uint32[activities + 1], successors of j are succ_target[succ_offset[j]..succ_offset[j + 1]) */
+    SECTION_SUCC_TARGET,                /**< int32[edges], successor indices, starting with 0 */
+    NUM_SECTIONS
+};
+
+/**
+ * @brief location of one section within the file
+ */
+struct BinarySectionEntry {
+    uint64_t            offset;         /**< byte offset from start of file, multiple of RGC_BINARY_ALIGNMENT */
+    uint64_t            size;           /**< size in bytes */
+};
+
+/**
+ * @brief fixed size header at the start of every binary instance
+ * @details readers have to reject files with a different magic, endian mark or a version they do not know. Sections added in later versions are appended to the section table, header_size grows accordingly.
+ */
+struct BinaryHeader {
+    char                magic[8];       /**< RGC_BINARY_MAGIC */
+    uint32_t            version;        /**< RGC_BINARY_VERSION */
+    uint32_t            endian_mark;    /**< RGC_BINARY_ENDIAN_MARK in byte order of the writer */
+    uint32_t            header_size;    /**< sizeof(BinaryHeader) of the writer */
+    uint32_t            flags;          /**< combination of RGC_BINARY_FLAG_* */
+    uint32_t            activities;     /**< number of activities */
+    uint32_t            resources;      /**< number of resources */
+    uint32_t            edges;          /**< number of precedence relations */
+    uint32_t            horizon;        /**< latest deadline */
+    BinarySectionEntry  sections[NUM_SECTIONS];
+};
+
+/**
+ * @brief read-only view of a contiguous array
+ */
+template<typename T> class Span {
+    const T            *_data;
+    size_t              _size;
+public:
+    Span():_data(NULL), _size(0) {}
+    Span(const T *data, const size_t size):_data(data), _size(size) {}
+
+    const T            *data() const {return _data;}
+    size_t              size() const {return _size;}
+    bool                empty() const {return _size == 0;}
+    const T            *begin() const {return _data;}
+    const T            *end() const {return _data + _size;}
+    const T&            operator [] (const size_t i) const {return _data[i];}
+};
+
+/**
+ * @brief read-only memory mapping of a whole file
+ */
+class MappedFile {
+    const unsigned char    *_data;
+    size_t                  _length;
+#if defined(WIN32) || defined(_WIN32)
+    HANDLE                  _file;
+    HANDLE                  _mapping;
+#endif
+
+    // not copyable
+    MappedFile(const MappedFile& other);
+    MappedFile& operator = (const MappedFile& other);
+
+public:
+    MappedFile():_data(NULL), _length(0) {
+#if defined(WIN32) || defined(_WIN32)
+        _file = INVALID_HANDLE_VALUE;
+        _mapping = NULL;
+#endif
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    /**
+     * @brief maps file into memory, a previously mapped file is unmapped first
+     *
+     * @param filename path of file to map
+     * @return true if file is not empty and could be mapped
+     */
+    bool open(const char *filename) {
+        close();
+#if defined(WIN32) || defined(_WIN32)
+        _file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(_file == INVALID_HANDLE_VALUE)return false;
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        _length = (size_t)size.QuadPart;
+        _mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(_mapping)_data = (const unsigned char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = ::open(filename, O_RDONLY);
+        if(fd < 0)return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        _length = (size_t)st.st_size;
+        void *p = mmap(NULL, _length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // mapping stays valid
+        _data = p == MAP_FAILED ? NULL : (const unsigned char *)p;
+#endif
+        if(!_data) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief unmaps file, all pointers into the mapping become invalid
+     */
+    void close() {
+#if defined(WIN32) || defined(_WIN32)
+        if(_data)UnmapViewOfFile(_data);
+        if(_mapping)CloseHandle(_mapping);
+        if(_file != INVALID_HANDLE_VALUE)CloseHandle(_file);
+        _mapping = NULL;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if(_data)munmap((void *)_data, _length);
+#endif
+        _data = NULL;
+        _length = 0;
+    }
+
+    const unsigned char    *data() const {return _data;}
+    size_t                  length() const {return _length;}
+};
+
+/**
+ * @brief memory mapped binary instance
+ * @details open maps the file and checks header and section table in constant time, afterwards all accessors return views into the mapping, i.e. nothing is copied or parsed. The successor lists are only checked by validate. Views become invalid once the instance is closed or destroyed.
+ */
+class BinaryInstance {
+    MappedFile              _file;          /**< mapping if opened via filename */
+    const unsigned char    *_base;
+    size_t                  _length;
+    const BinaryHeader     *_header;
+
+    // not copyable
+    BinaryInstance(const BinaryInstance& other);
+    BinaryInstance& operator = (const BinaryInstance& other);
+
+    template<typename T> Span<T> section(const int s) const {
+        return Span<T>((const T*)(_base + _header->sections[s].offset), (size_t)(_header->sections[s].size / sizeof(T)));
+    }
+
+    bool                    check_section(const int s, const uint64_t expected_size) const {
+        const BinarySectionEntry& e = _header->sections[s];
+        return e.offset % RGC_BINARY_ALIGNMENT == 0 && e.size == expected_size && e.offset <= _length && e.size <= _length - e.offset;
+    }
+
+    bool                    check() const {
+        if(_length < sizeof(BinaryHeader))return false;
+        if(memcmp(_header->magic, RGC_BINARY_MAGIC, 8) != 0)return false;
+        if(_header->endian_mark != RGC_BINARY_ENDIAN_MARK || _header->version != RGC_BINARY_VERSION)return false;
+        if(_header->header_size != sizeof(BinaryHeader))return false;
+
+        const uint64_t n = _header->activities, k = _header->resources, e = _header->edges;
+        if(!check_section(SECTION_DURATION, 4 * n) || !check_section(SECTION_RELEASE, 4 * n) || !check_section(SECTION_DEADLINE, 4 * n) ||
+           !check_section(SECTION_CAPACITY, 4 * k) || !check_section(SECTION_DEMAND, 4 * n * k) ||
+           !check_section(SECTION_SUCC_OFFSET, 4 * (n + 1)) || !check_section(SECTION_SUCC_TARGET, 4 * e))
+            return false;
+        return true;
+    }
+
+    bool                    attach(const void *data, const size_t length) {
+        if(!data || (size_t)data % RGC_BINARY_ALIGNMENT != 0)return false;
+        _base = (const unsigned char *)data;
+        _length = length;
+        _header = (const BinaryHeader *)_base;
+        if(!check()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+public:
+    BinaryInstance():_base(NULL), _length(0), _header(NULL) {}
+
+    /**
+     * @brief maps file into memory and validates its header
+     *
+     * @param filename path of binary instance
+     * @return true if file could be mapped and is a valid binary instance of a supported version
+     */
+    bool open(const char *filename) {
+        close();
+        if(!_file.open(filename))return false;
+        return attach(_file.data(), _file.length());
+    }
+
+    /**
+     * @brief attaches to an instance already in memory, e.g. an entry of a mapped bundle
+     *
+     * @param data start of the instance, has to be aligned to RGC_BINARY_ALIGNMENT
+     * @param length size of the instance in bytes
+     * @return true if data holds a valid binary instance of a supported version
+     */
+    bool open(const void *data, const size_t length) {
+        close();
+        return attach(data, length);
+    }
+
+    /**
+     * @brief detaches from the instance and unmaps the file if it was opened via filename, all views obtained before become invalid
+     */
+    void close() {
+        _file.close();
+        _base = NULL;
+        _header = NULL;
+        _length = 0;
+    }
+
+    /**
+     * @brief checks the successor lists, i.e. O(activities + edges)
+     * @details open only checks header and section bounds in constant time, so successors(j) of a corrupted file may point outside the successor targets and targets may not be activities. Call validate once after open for files from untrusted sources.
+     *
+     * @return true if successor offsets are monotone from 0 to the number of edges and all successors are activities of the instance
+     */
+    bool validate() const {
+        if(!is_open())return false;
+        const uint64_t n = _header->activities, e = _header->edges;
+
+        // successor offsets have to be monotone and end at the number of edges
+        Span<uint32_t> off = successor_offsets();
+        for(size_t j = 0; j < n; j++)if(off[j] > off[j + 1])return false;
+        if(off[0] != 0 || off[n] != e)return false;
+
+        // successors have to be activities of the instance
+        Span<int32_t> target = successor_targets();
+        for(size_t i = 0; i < e; i++)if(target[i] < 0 || (uint64_t)target[i] >= n)return false;
+        return true;
+    }
+
+    bool                    is_open() const {return _header != NULL;}
+
+    const BinaryHeader&     header() const {return *_header;}
+    uint32_t                activity_count() const {return _header->activities;}
+    uint32_t                resource_count() const {return _header->resources;}
+    uint32_t                edge_count() const {return _header->edges;}
+    uint32_t                horizon() const {return _header->horizon;}
+    bool                    dummynodes() const {return (_header->flags & RGC_BINARY_FLAG_DUMMYNODES) != 0;}
+
+    Span<int32_t>           durations() const {return section<int32_t>(SECTION_DURATION);}
+    Span<int32_t>           releases() const {return section<int32_t>(SECTION_RELEASE);}
+    Span<int32_t>           deadlines() const {return section<int32_t>(SECTION_DEADLINE);}
+    Span<int32_t>           capacities() const {return section<int32_t>(SECTION_CAPACITY);}
+    Span<int32_t>           demands() const {return section<int32_t>(SECTION_DEMAND);}
+    Span<uint32_t>          successor_offsets() const {return section<uint32_t>(SECTION_SUCC_OFFSET);}
+    Span<int32_t>           successor_targets() const {return section<int32_t>(SECTION_SUCC_TARGET);}
+
+    /**
+     * @return demands of activity j on all resources
+     */
+    Span<int32_t>           demands(const uint32_t j) const {
+        return Span<int32_t>(demands().data() + (size_t)j * _header->resources, _header->resources);
+    }
+
+    /**
+     * @return successors of activity j
+     */
+    Span<int32_t>           successors(const uint32_t j) const {
+        Span<uint32_t> off = successor_offsets();
+        return Span<int32_t>(successor_targets().data() + off[j], off[j + 1] - off[j]);
+    }
+};
+
+#endif
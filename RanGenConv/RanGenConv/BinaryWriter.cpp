@@ -0,0 +1,176 @@
+//
+//  BinaryWriter.cpp
+//  RanGenConv
+//
+
+#include "BinaryWriter.h"
+#include "SharedMemory.h"
+
+#include <vector>
+#include <iostream>
+
+/**
+ * @brief appends zero bytes until pos is a multiple of RGC_BINARY_ALIGNMENT
+ */
+static void pad(OutputSink& out, uint64_t& pos) {
+    static const char zeros[RGC_BINARY_ALIGNMENT] = {0};
+    uint64_t n = (RGC_BINARY_ALIGNMENT - pos % RGC_BINARY_ALIGNMENT) % RGC_BINARY_ALIGNMENT;
+    out.write(zeros, (size_t)n);
+    pos += n;
+}
+
+/**
+ * @brief appends an array of 32bit values as section s
+ */
+template<typename T> static void write_section(OutputSink& out, uint64_t& pos, const std::vector<T>& v) {
+    pad(out, pos);
+    if(!v.empty())out.write((const char *)&v[0], v.size() * sizeof(T));
+    pos += v.size() * sizeof(T);
+}
+
+/**
+ * @brief writes instance in binary format, see BinaryFormat.h
+ * @details if dummynodes is false, dummy start/end and their relations are left out and activities are renumbered starting with 0. All sections are laid out first, so the header can be written up front and the file in one sequential pass.
+ *
+ * @param file instance with generated times
+ * @param out sink to write to, positioned at a multiple of RGC_BINARY_ALIGNMENT (offsets are relative to this position)
+ * @param dummynodes set to true to include dummy nodes
+ * @return true if no errors occured
+ */
+bool write_binary(RanGenFile& file, OutputSink& out, const bool dummynodes) {
+    using namespace std;
+
+    const int offset = dummynodes ? 0 : 1;
+    const int n = (int)file.node_count() - 2 * offset;
+    const int K = (int)file.resource_count();
+    if(n <= 0)return false;
+
+    vector<int32_t> duration(n), release(n), deadline(n), capacity(K), demand((size_t)n * K, 0);
+    vector<uint32_t> succ_offset(n + 1, 0);
+    vector<int32_t> succ_target;
+    succ_target.reserve(file.edge_count());
+
+    for(int j = 0; j < n; j++) {
+        const node& a = file.nodes(j + offset);
+        duration[j] = a.activity_duration;
+        release[j] = a.release;
+        deadline[j] = a.deadline;
+        for(int k = 0; k < K && k < (int)a.resource_requirements.size(); k++)demand[(size_t)j * K + k] = a.resource_requirements[k];
+    }
+    for(int k = 0; k < K; k++)capacity[k] = file.resource_availability()[k];
+
+    // edge iterator yields edges sorted by source, i.e. CSR can be filled in one pass
+    for(RanGenFile::edge_iterator it = file.edges_begin(); it != file.edges_end(); ++it) {
+        if(!dummynodes && (it.source() == 0 || it.target() == file.node_count() - 1))continue;
+        succ_target.push_back(it.target() - offset);
+        succ_offset[it.source() - offset + 1]++;
+    }
+    for(int j = 0; j < n; j++)succ_offset[j + 1] += succ_offset[j];
+
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RGC_BINARY_MAGIC, 8);
+    header.version = RGC_BINARY_VERSION;
+    header.endian_mark = RGC_BINARY_ENDIAN_MARK;
+    header.header_size = sizeof(BinaryHeader);
+    header.flags = dummynodes ? RGC_BINARY_FLAG_DUMMYNODES : 0;
+    header.activities = n;
+    header.resources = K;
+    header.edges = (uint32_t)succ_target.size();
+    header.horizon = file.horizon();
+
+    const uint64_t sizes[NUM_SECTIONS] = {
+        4ULL * n, 4ULL * n, 4ULL * n, 4ULL * K, 4ULL * n * K, 4ULL * (n + 1), 4ULL * succ_target.size()
+    };
+    uint64_t pos = sizeof(BinaryHeader);
+    for(int s = 0; s < NUM_SECTIONS; s++) {
+        pos = (pos + RGC_BINARY_ALIGNMENT - 1) / RGC_BINARY_ALIGNMENT * RGC_BINARY_ALIGNMENT;
+        header.sections[s].offset = pos;
+        header.sections[s].size = sizes[s];
+        pos += sizes[s];
+    }
+
+    pos = sizeof(BinaryHeader);
+    out.write((const char *)&header, sizeof(header));
+    write_section(out, pos, duration);
+    write_section(out, pos, release);
+    write_section(out, pos, deadline);
+    write_section(out, pos, capacity);
+    write_section(out, pos, demand);
+    write_section(out, pos, succ_offset);
+    write_section(out, pos, succ_target);
+    pad(out, pos);
+
+    return out.good();
+}
+
+/**
+ * @brief writes instance in binary format to a file
+ *
+ * @param file instance with generated times
+ * @param ofilename path of file to write to
+ * @param dummynodes set to true to include dummy nodes
+ * @return true if no errors occured
+ */
+bool write_binary(RanGenFile& file, const char *ofilename, const bool dummynodes) {
+    OutputSink out;
+    if(!out.open(ofilename, true))return false;
+    bool res = write_binary(file, out, dummynodes);
+    return out.close() && res;
+}
+
+/**
+ * @brief publishes instance in binary format as POSIX shared memory segment (see SharedMemory.h)
+ * @details a segment of the same name is replaced, readers which mapped it before keep their mapping. The instance is formatted in memory first, the segment is created with the final size and marked ready once the instance is copied. The segment persists until it is removed via shm_unlink / SharedInstance::unlink.
+ *
+ * @param file instance with generated times
+ * @param name name of the segment, starting with /
+ * @param dummynodes set to true to include dummy nodes
+ * @param seed seed the times were generated with, stored in the segment header
+ * @return true if no errors occured
+ */
+bool write_binary_shared(RanGenFile& file, const char *name, const bool dummynodes, const unsigned long long seed) {
+    using namespace std;
+
+#if defined(WIN32) || defined(_WIN32)
+    cout<<"error: shared memory output is not supported on this platform"<<endl;
+    return false;
+#else
+    OutputSink instance;
+    instance.open_memory();
+    if(!write_binary(file, instance, dummynodes))return false;
+
+    const size_t offset = sizeof(SharedSegmentHeader);
+    const size_t length = offset + instance.size();
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0) {
+        cout<<"error: shared memory segment "<<name<<" could not be created"<<endl;
+        return false;
+    }
+    void *p = ftruncate(fd, (off_t)length) == 0 ? mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if(p == MAP_FAILED) {
+        cout<<"error: shared memory segment "<<name<<" could not be mapped"<<endl;
+        shm_unlink(name);
+        return false;
+    }
+
+    SharedSegmentHeader *header = (SharedSegmentHeader *)p;
+    header->version = RGC_SHM_VERSION;
+    header->state = RGC_SHM_STATE_WRITING;
+    header->offset = offset;
+    header->size = instance.size();
+    header->seed = seed;
+    memcpy(header->magic, RGC_SHM_MAGIC, 8);
+    memcpy((char *)p + offset, instance.data(), instance.size());
+
+    // readers check the state before the instance
+    atomic_thread_fence(memory_order_release);
+    header->state = RGC_SHM_STATE_READY;
+
+    munmap(p, length);
+    return true;
+#endif
+}
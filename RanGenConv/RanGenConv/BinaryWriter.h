@@ -0,0 +1,17 @@
+//
+//  BinaryWriter.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_BinaryWriter_h
+#define RanGenConv_BinaryWriter_h
+
+#include "RanGenFile.h"
+#include "BinaryFormat.h"
+#include "OutputSink.h"
+
+bool                        write_binary(RanGenFile& file, OutputSink& out, const bool dummynodes);
+bool                        write_binary(RanGenFile& file, const char *ofilename, const bool dummynodes);
+bool                        write_binary_shared(RanGenFile& file, const char *name, const bool dummynodes, const unsigned long long seed);
+
+#endif
@@ -0,0 +1,308 @@
+//
+//  BundleFormat.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_BundleFormat_h
+#define RanGenConv_BundleFormat_h
+
+// header-only reader of the bundle container written by RanGenConv -b.
+// Depends only on BinaryFormat.h, copy both to your solver's code base.
+
+#include "BinaryFormat.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define RGC_BUNDLE_MAGIC "RGCBNDL\0"
+#define RGC_BUNDLE_VERSION 2
+
+#define RGC_BUNDLE_FORMAT_DAT 0         /**< entry holds a .dat file */
+#define RGC_BUNDLE_FORMAT_BINARY 1      /**< entry holds a binary instance, see BinaryFormat.h */
+#define RGC_BUNDLE_FORMAT_GRAPHML 2     /**< entry holds a GraphML file */
+
+/**
+ * @brief header at the start of every bundle, padded to RGC_BINARY_ALIGNMENT bytes
+ */
+struct BundleHeader {
+    char                magic[8];       /**< RGC_BUNDLE_MAGIC */
+    uint32_t            version;        /**< RGC_BUNDLE_VERSION */
+    uint32_t            endian_mark;    /**< RGC_BINARY_ENDIAN_MARK in byte order of the writer */
+    char                padding[RGC_BINARY_ALIGNMENT - 16];
+};
+
+/**
+ * @brief index record of one instance of a bundle
+ */
+struct BundleEntry {
+    uint64_t            offset;         /**< byte offset of the instance from start of bundle, multiple of RGC_BINARY_ALIGNMENT */
+    uint64_t            length;         /**< size of the instance in bytes */
+    uint32_t            name_offset;    /**< offset of name within the name table of its segment */
+    uint32_t            name_length;    /**< length of name, names are not terminated */
+    uint32_t            format;         /**< RGC_BUNDLE_FORMAT_* */
+    uint32_t            seed;           /**< seed the times were generated with */
+    uint32_t            activities;     /**< number of activities */
+    uint32_t            resources;      /**< number of resources */
+    uint32_t            edges;          /**< number of precedence relations including those of dummies */
+    uint32_t            horizon;        /**< latest deadline */
+    double              cnc;            /**< coefficient of network complexity */
+    double              order_strength; /**< order strength */
+    double              resource_factor;/**< resource factor */
+    double              resource_strength; /**< average resource strength over all resources */
+};
+
+/**
+ * @brief trailer at the very end of every bundle, locates the index segment written last
+ * @details bundles are append-only: each run of the writer adds its instances behind the trailer, followed by an index segment and a new trailer. A segment lists the instances first_id, ..., first_id + count - 1 and refers to the trailer of the segment before, so the index of a bundle is the chain of segments ending at its last trailer. To keep the chain short, a new segment absorbs the segments before it as long as they hold at most twice as many instances, hence segments at least double in size from newest to oldest and a bundle of n instances has at most log2(n) + 1 of them. Absorbed segments and instances written before are never moved or overwritten. Hence a reader which mapped the bundle before keeps a consistent view, and if a run is interrupted before its trailer is complete the previous trailer still locates a valid index (see BundleReader::open).
+ */
+struct BundleTrailer {
+    uint64_t            index_offset;   /**< offset of BundleEntry[count], multiple of RGC_BINARY_ALIGNMENT */
+    uint64_t            count;          /**< number of instances of this segment */
+    uint64_t            by_name_offset; /**< offset of uint32[by_name_count] ids within this segment sorted by name, latest instance of equal names only */
+    uint64_t            by_name_count;
+    uint64_t            names_offset;   /**< offset of name table of this segment */
+    uint64_t            names_size;     /**< size of name table in bytes */
+    uint64_t            first_id;       /**< id of the first instance of this segment, i.e. number of instances in the segments before */
+    uint64_t            previous;       /**< offset of the end of the trailer of the segment before, 0 if this is the first segment */
+    uint32_t            version;        /**< RGC_BUNDLE_VERSION */
+    uint32_t            endian_mark;    /**< RGC_BINARY_ENDIAN_MARK in byte order of the writer */
+    char                magic[8];       /**< RGC_BUNDLE_MAGIC */
+};
+
+/**
+ * @brief memory mapped bundle of instances
+ * @details open maps the file and checks the trailers and index segments, afterwards instances are accessed by id (order they were added in) or by name in O(log n) per segment without reading anything but the index and the instance itself.
+ */
+class BundleReader {
+    /**
+     * @brief index segment located by a trailer
+     */
+    struct Segment {
+        const BundleTrailer    *trailer;
+        const BundleEntry      *entries;
+        const uint32_t         *by_name;
+        const char             *names;
+        size_t                  end;                /**< offset of the end of the trailer */
+    };
+
+    MappedFile              _file;
+    size_t                  _length;            /**< bytes up to the end of the trailer in use */
+    uint32_t                _count;             /**< number of instances in all segments */
+    std::vector<Segment>    _segments;          /**< oldest first */
+
+    // not copyable
+    BundleReader(const BundleReader& other);
+    BundleReader& operator = (const BundleReader& other);
+
+    static bool             in_file(const uint64_t offset, const uint64_t size, const size_t length) {
+        return offset <= length && size <= length - offset;
+    }
+
+    /**
+     * @brief checks the trailer ending at byte length and the index segment it locates
+     */
+    bool                    check(const size_t length) const {
+        const unsigned char *base = _file.data();
+        if(length < sizeof(BundleHeader) + sizeof(BundleTrailer) || length % 8 != 0)return false;
+
+        const BundleHeader *header = (const BundleHeader *)base;
+        if(memcmp(header->magic, RGC_BUNDLE_MAGIC, 8) != 0 || header->endian_mark != RGC_BINARY_ENDIAN_MARK || header->version != RGC_BUNDLE_VERSION)return false;
+
+        const BundleTrailer *t = (const BundleTrailer *)(base + length - sizeof(BundleTrailer));
+        if(memcmp(t->magic, RGC_BUNDLE_MAGIC, 8) != 0 || t->endian_mark != RGC_BINARY_ENDIAN_MARK || t->version != RGC_BUNDLE_VERSION)return false;
+        if(t->index_offset % RGC_BINARY_ALIGNMENT != 0 || t->count > length / sizeof(BundleEntry) || t->by_name_count > t->count)return false;
+        if(!in_file(t->index_offset, t->count * sizeof(BundleEntry), length) || !in_file(t->by_name_offset, t->by_name_count * 4, length) ||
+           !in_file(t->names_offset, t->names_size, length) || t->by_name_offset % 4 != 0 || t->previous > t->index_offset)
+            return false;
+
+        const BundleEntry *e = (const BundleEntry *)(base + t->index_offset);
+        const uint32_t *by_name = (const uint32_t *)(base + t->by_name_offset);
+        for(uint64_t i = 0; i < t->count; i++)
+            if(!in_file(e[i].offset, e[i].length, length) || !in_file(e[i].name_offset, e[i].name_length, t->names_size))return false;
+        for(uint64_t i = 0; i < t->by_name_count; i++)
+            if(by_name[i] >= t->count)return false;
+        return true;
+    }
+
+    /**
+     * @brief checks the chain of segments ending at byte length and collects them
+     */
+    bool                    load(const size_t length) {
+        _segments.clear();
+        for(size_t end = length; ; ) {
+            if(!check(end))return false;
+            Segment s;
+            s.trailer = (const BundleTrailer *)(_file.data() + end - sizeof(BundleTrailer));
+            s.entries = (const BundleEntry *)(_file.data() + s.trailer->index_offset);
+            s.by_name = (const uint32_t *)(_file.data() + s.trailer->by_name_offset);
+            s.names = (const char *)(_file.data() + s.trailer->names_offset);
+            s.end = end;
+            _segments.insert(_segments.begin(), s);
+            if(s.trailer->previous == 0)break;
+            end = (size_t)s.trailer->previous;
+        }
+
+        // ids have to be consecutive over the segments
+        uint64_t count = 0;
+        for(size_t i = 0; i < _segments.size(); i++) {
+            if(_segments[i].trailer->first_id != count)return false;
+            count += _segments[i].trailer->count;
+        }
+        if(count > 0xFFFFFFFFu)return false;
+        _count = (uint32_t)count;
+        return true;
+    }
+
+    /**
+     * @brief locates the segment of instance #id
+     */
+    const Segment&          segment_of(const uint32_t id) const {
+        size_t lo = 0, hi = _segments.size() - 1;
+        while(lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            if(_segments[mid].trailer->first_id <= id)lo = mid;
+            else hi = mid - 1;
+        }
+        return _segments[lo];
+    }
+
+    /**
+     * @return <0, 0, >0 if name of entry #id of segment s is less than, equal to or greater than name
+     */
+    static int              compare(const Segment& s, const uint32_t id, const char *name, const size_t length) {
+        const BundleEntry& e = s.entries[id];
+        int c = memcmp(s.names + e.name_offset, name, e.name_length < length ? e.name_length : length);
+        if(c != 0)return c;
+        return e.name_length < length ? -1 : (e.name_length > length ? 1 : 0);
+    }
+
+public:
+    BundleReader():_length(0), _count(0) {}
+
+    /**
+     * @brief maps bundle into memory and validates trailers and index segments
+     * @details if the file does not end with a valid trailer, e.g. because a writer was interrupted, the latest valid trailer before is used, i.e. the bundle is opened as it was before the interrupted run. Trailers are 8 byte aligned, hence the search takes time linear in the size of the damaged tail.
+     *
+     * @param filename path of bundle
+     * @return true if file is a valid bundle of a supported version holding at least one complete trailer
+     */
+    bool open(const char *filename) {
+        close();
+        if(!_file.open(filename))return false;
+        if((size_t)_file.data() % 8 != 0) {
+            close();
+            return false;
+        }
+        const size_t min_length = sizeof(BundleHeader) + sizeof(BundleTrailer);
+        for(size_t length = _file.length() / 8 * 8; length >= min_length; length -= 8) {
+            if(memcmp(_file.data() + length - 8, RGC_BUNDLE_MAGIC, 8) == 0 && load(length)) {
+                _length = length;
+                break;
+            }
+        }
+        if(_length == 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief unmaps bundle, all pointers obtained before become invalid
+     */
+    void close() {
+        _file.close();
+        _length = 0;
+        _count = 0;
+        _segments.clear();
+    }
+
+    bool                    is_open() const {return _length != 0;}
+
+    /**
+     * @return size of the bundle up to the end of the trailer in use, bytes behind it belong to an interrupted run
+     */
+    size_t                  length() const {return _length;}
+
+    /**
+     * @return number of instances in the bundle
+     */
+    uint32_t                count() const {return _count;}
+
+    /**
+     * @return number of index segments, see BundleTrailer
+     */
+    uint32_t                segments() const {return (uint32_t)_segments.size();}
+
+    /**
+     * @return trailer of segment #i, segments are ordered oldest first
+     */
+    const BundleTrailer&    trailer(const uint32_t i) const {return *_segments[i].trailer;}
+
+    /**
+     * @return offset of the end of the trailer of segment #i
+     */
+    size_t                  segment_end(const uint32_t i) const {return _segments[i].end;}
+
+    /**
+     * @return index record of instance #id, ids start with 0
+     */
+    const BundleEntry&      entry(const uint32_t id) const {
+        const Segment& s = segment_of(id);
+        return s.entries[id - s.trailer->first_id];
+    }
+
+    /**
+     * @return name of instance #id
+     */
+    std::string             name(const uint32_t id) const {
+        const Segment& s = segment_of(id);
+        const BundleEntry& e = s.entries[id - s.trailer->first_id];
+        return std::string(s.names + e.name_offset, e.name_length);
+    }
+
+    /**
+     * @return contents of instance #id
+     */
+    Span<char>              data(const uint32_t id) const {
+        const BundleEntry& e = entry(id);
+        return Span<char>((const char *)(_file.data() + e.offset), (size_t)e.length);
+    }
+
+    /**
+     * @brief looks up an instance by name via binary search in each segment, newest first
+     *
+     * @param name name the instance was added with
+     * @return id of the latest instance added with this name, -1 if there is none
+     */
+    int                     find(const std::string& name) const {
+        for(size_t i = _segments.size(); i-- > 0; ) {
+            const Segment& s = _segments[i];
+            size_t lo = 0, hi = (size_t)s.trailer->by_name_count;
+            while(lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                int c = compare(s, s.by_name[mid], name.data(), name.size());
+                if(c == 0)return (int)(s.trailer->first_id + s.by_name[mid]);
+                if(c < 0)lo = mid + 1;
+                else hi = mid;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief opens instance #id stored in binary format without copying it
+     *
+     * @param id id of instance
+     * @param instance instance to attach to the bundle's memory, valid as long as the bundle is open
+     * @return true if the instance is a valid binary instance
+     */
+    bool                    binary(const uint32_t id, BinaryInstance& instance) const {
+        const BundleEntry& e = entry(id);
+        if(e.format != RGC_BUNDLE_FORMAT_BINARY)return false;
+        return instance.open(_file.data() + e.offset, (size_t)e.length);
+    }
+};
+
+#endif
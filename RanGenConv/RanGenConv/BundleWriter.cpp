@@ -0,0 +1,291 @@
+//
+//  BundleWriter.cpp
+//  RanGenConv
+//
+
+#include "BundleWriter.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(WIN32) || defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/file.h>
+#endif
+
+BundleWriter::BundleWriter():_lock(-1), _base(0), _opened(0), _indexed(false) {
+
+}
+
+BundleWriter::~BundleWriter() {
+    close();
+}
+
+/**
+ * @brief appends zero bytes until the bundle's size is a multiple of alignment
+ */
+void BundleWriter::pad(const uint64_t alignment) {
+    static const char zeros[RGC_BINARY_ALIGNMENT] = {0};
+    _out.write(zeros, (size_t)((alignment - position() % alignment) % alignment));
+}
+
+/**
+ * @brief orders ids of entries by their name
+ */
+class NameOrder {
+    const std::vector<BundleEntry>& _entries;
+    const std::string&              _names;
+public:
+    NameOrder(const std::vector<BundleEntry>& entries, const std::string& names):_entries(entries), _names(names) {}
+
+    bool operator () (const uint32_t a, const uint32_t b) const {
+        return _names.compare(_entries[a].name_offset, _entries[a].name_length, _names, _entries[b].name_offset, _entries[b].name_length) < 0;
+    }
+};
+
+/**
+ * @brief reads the index of an existing, non-empty bundle
+ * @details if the bundle does not end with a valid trailer, e.g. because a previous run was interrupted, the index of the latest valid trailer is used (see BundleReader::open). If there is none at all but the header is valid, the bundle is treated as empty.
+ *
+ * @param filename path of bundle
+ * @param length set to the size of the valid part of the bundle, bytes behind belong to an interrupted run
+ * @return false if the file is not a bundle
+ */
+bool BundleWriter::recover(const char *filename, uint64_t& length) {
+    BundleReader reader;
+    if(reader.open(filename)) {
+        // keep index of all instances written so far, names are compacted into a new table
+        for(uint32_t i = 0; i < reader.count(); i++) {
+            BundleEntry e = reader.entry(i);
+            e.name_offset = (uint32_t)_names.size();
+            _names += reader.name(i);
+            _entries.push_back(e);
+        }
+        for(uint32_t i = 0; i < reader.segments(); i++) {
+            Segment segment;
+            segment.first_id = reader.trailer(i).first_id;
+            segment.count = reader.trailer(i).count;
+            segment.end = reader.segment_end(i);
+            _segments.push_back(segment);
+        }
+        length = reader.length();
+        _indexed = true;
+        return true;
+    }
+
+    MappedFile file;
+    if(!file.open(filename) || file.length() < sizeof(BundleHeader))return false;
+    const BundleHeader *header = (const BundleHeader *)file.data();
+    if(memcmp(header->magic, RGC_BUNDLE_MAGIC, 8) != 0 || header->endian_mark != RGC_BINARY_ENDIAN_MARK || header->version != RGC_BUNDLE_VERSION)return false;
+    length = sizeof(BundleHeader);
+    return true;
+}
+
+/**
+ * @brief releases the lock of the bundle
+ */
+void BundleWriter::unlock() {
+    if(_lock < 0)return;
+#if defined(WIN32) || defined(_WIN32)
+    OVERLAPPED region;
+    memset(&region, 0, sizeof(region));
+    region.Offset = 0xFFFFFFFF;
+    region.OffsetHigh = 0x7FFFFFFF;
+    UnlockFileEx((HANDLE)_get_osfhandle(_lock), 0, 1, 0, &region);
+    _close(_lock);
+#else
+    flock(_lock, LOCK_UN);
+    ::close(_lock);
+#endif
+    _lock = -1;
+}
+
+/**
+ * @brief opens a bundle for appending, creates it if it does not exist or is empty
+ * @details takes an advisory lock on the bundle, which is held until close, i.e. another writer of the same bundle waits until this one finished. Bytes an interrupted run left behind the latest valid trailer are cut off.
+ *
+ * @param filename path of bundle
+ * @return false if the file could not be opened or is not a valid bundle
+ */
+bool BundleWriter::open(const char *filename) {
+    using namespace std;
+
+    close();
+    _entries.clear();
+    _names.clear();
+    _segments.clear();
+    _base = 0;
+    _indexed = false;
+
+#if defined(WIN32) || defined(_WIN32)
+    _lock = _open(filename, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if(_lock < 0)return false;
+    // locks are mandatory on Windows, hence a byte far behind the data is locked
+    OVERLAPPED region;
+    memset(&region, 0, sizeof(region));
+    region.Offset = 0xFFFFFFFF;
+    region.OffsetHigh = 0x7FFFFFFF;
+    struct _stat64 st;
+    if(!LockFileEx((HANDLE)_get_osfhandle(_lock), LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &region) || _fstat64(_lock, &st) != 0) {
+#else
+    _lock = ::open(filename, O_RDWR | O_CREAT, 0644);
+    if(_lock < 0)return false;
+    struct stat st;
+    if(flock(_lock, LOCK_EX) != 0 || fstat(_lock, &st) != 0) {
+#endif
+        unlock();
+        return false;
+    }
+
+    uint64_t length = 0;
+    if(st.st_size > 0 && !recover(filename, length)) {
+        _entries.clear();
+        _names.clear();
+        _segments.clear();
+        unlock();
+        return false;
+    }
+    _opened = _entries.size();
+    // bytes of an interrupted run are cut off
+#if defined(WIN32) || defined(_WIN32)
+    if(length < (uint64_t)st.st_size && _chsize_s(_lock, (long long)length) != 0) {
+#else
+    if(length < (uint64_t)st.st_size && ftruncate(_lock, (off_t)length) != 0) {
+#endif
+        unlock();
+        return false;
+    }
+    _base = length;
+
+    if(!_out.open(filename, true, length > 0)) {
+        unlock();
+        return false;
+    }
+    if(length == 0) {
+        BundleHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, RGC_BUNDLE_MAGIC, 8);
+        header.version = RGC_BUNDLE_VERSION;
+        header.endian_mark = RGC_BINARY_ENDIAN_MARK;
+        _out.write((const char *)&header, sizeof(header));
+    }
+
+    return _out.good();
+}
+
+/**
+ * @brief appends an instance, may be called concurrently
+ *
+ * @param name name to look up the instance by, an older instance of the same name is shadowed but kept
+ * @param format one of RGC_BUNDLE_FORMAT_*
+ * @param seed seed the times of the instance were generated with
+ * @param data contents of the instance
+ * @param length size of data in bytes
+ * @param metrics metrics as computed by compute_metrics
+ * @param horizon latest deadline of the instance
+ * @return true if no errors occured so far
+ */
+bool BundleWriter::add(const std::string& name, const uint32_t format, const uint32_t seed, const char *data, const size_t length,
+                       const InstanceMetrics& metrics, const uint32_t horizon) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!_out.good())return false;
+
+    // instances start aligned, so that binary instances can be used in place
+    pad(RGC_BINARY_ALIGNMENT);
+
+    BundleEntry e;
+    memset(&e, 0, sizeof(e));
+    e.offset = position();
+    e.length = length;
+    e.name_offset = (uint32_t)_names.size();
+    e.name_length = (uint32_t)name.size();
+    e.format = format;
+    e.seed = seed;
+    e.activities = metrics.activities;
+    e.resources = metrics.resources;
+    e.edges = metrics.arcs;
+    e.horizon = horizon;
+    e.cnc = metrics.cnc;
+    e.order_strength = metrics.order_strength;
+    e.resource_factor = metrics.resource_factor;
+    e.resource_strength = metrics.mean_resource_strength();
+    _out.write(data, length);
+    _names += name;
+    _entries.push_back(e);
+
+    return _out.good();
+}
+
+/**
+ * @brief writes index segment and trailer, closes the bundle and releases its lock
+ * @details the new segment lists the instances added since open. Preceding segments holding at most twice as many instances are absorbed, i.e. their instances are listed again by the new segment, which then refers to the segment before them. If writing failed, no index is written, hence readers and the next writer keep using the previous one. No index is written either if no instance was added to a bundle which has one already.
+ * @return true if all instances and the index were written successfully
+ */
+bool BundleWriter::close() {
+    using namespace std;
+
+    if(_lock < 0)return true;
+
+    bool res = _out.good();
+    if(res && (_entries.size() > _opened || !_indexed)) {
+        BundleTrailer trailer;
+        memset(&trailer, 0, sizeof(trailer));
+
+        uint64_t first = _opened;
+        while(!_segments.empty() && _segments.back().count <= 2 * (_entries.size() - first)) {
+            first = _segments.back().first_id;
+            _segments.pop_back();
+        }
+        trailer.first_id = first;
+        trailer.previous = _segments.empty() ? 0 : _segments.back().end;
+
+        // entries of the segment refer to its own name table
+        vector<BundleEntry> entries(_entries.begin() + first, _entries.end());
+        string names;
+        for(size_t i = 0; i < entries.size(); i++) {
+            const uint32_t offset = (uint32_t)names.size();
+            names.append(_names, entries[i].name_offset, entries[i].name_length);
+            entries[i].name_offset = offset;
+        }
+
+        // index
+        pad(RGC_BINARY_ALIGNMENT);
+        trailer.index_offset = position();
+        trailer.count = entries.size();
+        if(!entries.empty())_out.write((const char *)&entries[0], entries.size() * sizeof(BundleEntry));
+
+        // ids sorted by name, the latest one of equal names is kept only
+        vector<uint32_t> ids(entries.size());
+        for(uint32_t i = 0; i < ids.size(); i++)ids[i] = i;
+        stable_sort(ids.begin(), ids.end(), NameOrder(entries, names));
+        vector<uint32_t> by_name;
+        NameOrder less(entries, names);
+        for(size_t i = 0; i < ids.size(); i++)
+            if(i + 1 == ids.size() || less(ids[i], ids[i + 1]))by_name.push_back(ids[i]);
+
+        trailer.by_name_offset = position();
+        trailer.by_name_count = by_name.size();
+        if(!by_name.empty())_out.write((const char *)&by_name[0], by_name.size() * sizeof(uint32_t));
+
+        trailer.names_offset = position();
+        trailer.names_size = names.size();
+        _out<<names;
+
+        // trailer ends the file and has to be aligned for readers
+        pad(8);
+        trailer.version = RGC_BUNDLE_VERSION;
+        trailer.endian_mark = RGC_BINARY_ENDIAN_MARK;
+        memcpy(trailer.magic, RGC_BUNDLE_MAGIC, 8);
+        _out.write((const char *)&trailer, sizeof(trailer));
+    }
+    if(!_out.close())res = false;
+
+    _entries.clear();
+    _names.clear();
+    _segments.clear();
+    unlock();
+    return res;
+}
@@ -0,0 +1,66 @@
+//
+//  BundleWriter.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_BundleWriter_h
+#define RanGenConv_BundleWriter_h
+
+#include "BundleFormat.h"
+#include "OutputSink.h"
+#include "Metrics.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+/**
+ * @brief appends instances to a bundle, see BundleFormat.h
+ * @details open locks the bundle against other writers and reads its index into memory. Instances are then appended one after another via add, which may be called concurrently, e.g. by the workers of a batch. close writes an index segment of the new instances, merged with the preceding segments as described in BundleFormat.h, followed by a new trailer and releases the lock. Instances added between open and close are only visible to readers once close succeeded.
+ */
+class BundleWriter {
+private:
+    /**
+     * @brief index segment the bundle had when it was opened
+     */
+    struct Segment {
+        uint64_t                first_id;
+        uint64_t                count;
+        uint64_t                end;            /**< offset of the end of its trailer */
+    };
+
+    OutputSink                  _out;
+    int                         _lock;          /**< descriptor holding the advisory lock of the bundle, -1 if not opened */
+    uint64_t                    _base;          /**< size of the bundle before it was opened */
+    std::vector<BundleEntry>    _entries;
+    std::string                 _names;         /**< names of all instances */
+    std::vector<Segment>        _segments;      /**< oldest first */
+    uint64_t                    _opened;        /**< number of instances when the bundle was opened */
+    bool                        _indexed;       /**< bundle had a valid index when it was opened */
+    std::mutex                  _mutex;         /**< serialises add */
+
+    uint64_t                    position() const {return _base + _out.tell();}
+    void                        pad(const uint64_t alignment);
+    bool                        recover(const char *filename, uint64_t& length);
+    void                        unlock();
+
+    // not copyable
+    BundleWriter(const BundleWriter& other);
+    BundleWriter& operator = (const BundleWriter& other);
+
+public:
+    BundleWriter();
+    ~BundleWriter();
+
+    bool                        open(const char *filename);
+    bool                        add(const std::string& name, const uint32_t format, const uint32_t seed, const char *data, const size_t length,
+                                    const InstanceMetrics& metrics, const uint32_t horizon);
+    bool                        close();
+
+    /**
+     * @return number of instances including those added since open
+     */
+    size_t                      count() {std::lock_guard<std::mutex> lock(_mutex); return _entries.size();}
+};
+
+#endif
@@ -0,0 +1,239 @@
+//
+//  Compression.cpp
+//  RanGenConv
+//
+
+#include "Compression.h"
+
+#ifdef RANGENCONV_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef RANGENCONV_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// size of the buffer holding compressed data before it is written
+#define COMPRESSED_CHUNK (1 << 18)
+
+Compressor::~Compressor() {
+    finish();
+}
+
+/**
+ * @brief initializes the compression stream and starts the compressor thread
+ *
+ * @param file file opened for writing, which is not closed by the compressor
+ * @param method gzip or zstd
+ * @return false if method is not available or the stream could not be initialized
+ */
+bool Compressor::start(FILE *file, const CompressionMethod method) {
+    if(_stream || !file)return false;
+
+    _file = file;
+    _method = method;
+    _out.resize(COMPRESSED_CHUNK);
+
+    switch(method) {
+#ifdef RANGENCONV_HAVE_ZLIB
+        case COMPRESSION_GZIP: {
+            z_stream *z = new z_stream();
+            // window bits + 16 selects the gzip header instead of zlib's
+            if(deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                delete z;
+                return false;
+            }
+            _stream = z;
+            break;
+        }
+#endif
+#ifdef RANGENCONV_HAVE_ZSTD
+        case COMPRESSION_ZSTD: {
+            ZSTD_CStream *z = ZSTD_createCStream();
+            if(!z || ZSTD_isError(ZSTD_initCStream(z, ZSTD_CLEVEL_DEFAULT))) {
+                ZSTD_freeCStream(z);
+                return false;
+            }
+            _stream = z;
+            break;
+        }
+#endif
+        default:
+            return false;
+    }
+
+    _has_full = false;
+    _done = false;
+    _good = true;
+    _thread = std::thread(&Compressor::run, this);
+    return true;
+}
+
+/**
+ * @brief compresses n bytes of data and writes the compressed data produced so far
+ *
+ * @param data uncompressed bytes
+ * @param n number of bytes
+ * @param last set to true to end the stream after data
+ * @return true if no errors occured
+ */
+bool Compressor::compress(const char *data, const size_t n, const bool last) {
+    switch(_method) {
+#ifdef RANGENCONV_HAVE_ZLIB
+        case COMPRESSION_GZIP: {
+            z_stream *z = (z_stream *)_stream;
+            z->next_in = (Bytef *)data;
+            z->avail_in = (uInt)n;
+            int ret;
+            do {
+                z->next_out = (Bytef *)&_out[0];
+                z->avail_out = (uInt)_out.size();
+                ret = deflate(z, last ? Z_FINISH : Z_NO_FLUSH);
+                if(ret == Z_STREAM_ERROR)return false;
+                const size_t produced = _out.size() - z->avail_out;
+                if(produced > 0 && fwrite(&_out[0], 1, produced, _file) != produced)return false;
+            } while(z->avail_out == 0 || (last && ret != Z_STREAM_END));
+            return true;
+        }
+#endif
+#ifdef RANGENCONV_HAVE_ZSTD
+        case COMPRESSION_ZSTD: {
+            ZSTD_inBuffer in = {data, n, 0};
+            size_t remaining;
+            do {
+                ZSTD_outBuffer out = {&_out[0], _out.size(), 0};
+                remaining = ZSTD_compressStream2((ZSTD_CStream *)_stream, &out, &in, last ? ZSTD_e_end : ZSTD_e_continue);
+                if(ZSTD_isError(remaining))return false;
+                if(out.pos > 0 && fwrite(&_out[0], 1, out.pos, _file) != out.pos)return false;
+            } while(last ? remaining != 0 : in.pos < in.size);
+            return true;
+        }
+#endif
+        default:
+            // parameters are unused if built without zlib and zstd
+            (void)data;
+            (void)n;
+            (void)last;
+            return false;
+    }
+}
+
+/**
+ * @brief body of the compressor thread, compresses buffers until finish is called
+ */
+void Compressor::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for(;;) {
+        _changed.wait(lock, [this]() {return _has_full || _done;});
+        if(_has_full) {
+            // the sink does not touch _full until _has_full is reset
+            lock.unlock();
+            const bool res = _good && compress(&_full[0], _full_used, false);
+            lock.lock();
+            if(!res)_good = false;
+            _has_full = false;
+            _changed.notify_all();
+            continue;
+        }
+        break;
+    }
+    lock.unlock();
+    if(!(_good && compress(NULL, 0, true)))_good = false;
+}
+
+/**
+ * @brief hands a full buffer to the compressor thread
+ * @details waits until the previous buffer is compressed, then swaps it with buffer. buffer keeps its size.
+ *
+ * @param buffer buffer of the sink
+ * @param used number of bytes of buffer in use
+ */
+void Compressor::push(std::vector<char>& buffer, const size_t used) {
+    if(!_stream || used == 0)return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this]() {return !_has_full;});
+    const size_t capacity = buffer.size();
+    _full.swap(buffer);
+    if(buffer.size() < capacity)buffer.resize(capacity);
+    _full_used = used;
+    _has_full = true;
+    _changed.notify_all();
+}
+
+/**
+ * @brief compresses the remaining buffer, ends the stream and stops the compressor thread
+ * @return true if all data was compressed and written successfully
+ */
+bool Compressor::finish() {
+    if(!_stream)return _good;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this]() {return !_has_full;});
+        _done = true;
+        _changed.notify_all();
+    }
+    _thread.join();
+
+    switch(_method) {
+#ifdef RANGENCONV_HAVE_ZLIB
+        case COMPRESSION_GZIP:
+            deflateEnd((z_stream *)_stream);
+            delete (z_stream *)_stream;
+            break;
+#endif
+#ifdef RANGENCONV_HAVE_ZSTD
+        case COMPRESSION_ZSTD:
+            ZSTD_freeCStream((ZSTD_CStream *)_stream);
+            break;
+#endif
+        default:
+            break;
+    }
+    _stream = NULL;
+    return _good;
+}
+
+/**
+ * @return true if the program was built with support for method
+ */
+bool compression_available(const CompressionMethod method) {
+    switch(method) {
+        case COMPRESSION_NONE:
+            return true;
+#ifdef RANGENCONV_HAVE_ZLIB
+        case COMPRESSION_GZIP:
+            return true;
+#endif
+#ifdef RANGENCONV_HAVE_ZSTD
+        case COMPRESSION_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief parses name of a compression method
+ *
+ * @param name none, gzip (gz) or zstd (zst)
+ * @param method set to the method named
+ * @return false if name is unknown
+ */
+bool parse_compression(const std::string& name, CompressionMethod& method) {
+    if(name == "none")method = COMPRESSION_NONE;
+    else if(name == "gzip" || name == "gz")method = COMPRESSION_GZIP;
+    else if(name == "zstd" || name == "zst")method = COMPRESSION_ZSTD;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief returns name of a compressed file, i.e. filename followed by the suffix of method unless it ends with it already
+ */
+std::string compressed_name(const std::string& filename, const CompressionMethod method) {
+    const std::string suffix = method == COMPRESSION_GZIP ? ".gz" : method == COMPRESSION_ZSTD ? ".zst" : "";
+    if(filename.size() >= suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0)return filename;
+    return filename + suffix;
+}
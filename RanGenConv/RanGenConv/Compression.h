@@ -0,0 +1,69 @@
+//
+//  Compression.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Compression_h
+#define RanGenConv_Compression_h
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// compressed output requires zlib (gzip) and/or libzstd (zstd), enable them by defining
+// RANGENCONV_HAVE_ZLIB (link with -lz) and RANGENCONV_HAVE_ZSTD (link with -lzstd)
+
+/**
+ * @brief compression of an output file
+ */
+enum CompressionMethod {
+    COMPRESSION_NONE = 0,               /**< plain file */
+    COMPRESSION_GZIP,                   /**< gzip stream via zlib, suffix .gz */
+    COMPRESSION_ZSTD                    /**< zstd frame via libzstd, suffix .zst */
+};
+
+/**
+ * @brief compresses the buffers of an OutputSink on a thread of its own and writes them to a file
+ * @details the sink hands over its buffer once it is full via push, which swaps it for the buffer compressed before. Hence formatting the next buffer overlaps with compressing the previous one, while at most two buffers exist. finish ends the stream and waits for the thread. Errors are sticky and reported via good and finish.
+ */
+class Compressor {
+private:
+    FILE                   *_file;
+    CompressionMethod       _method;
+    void                   *_stream;            /**< z_stream or ZSTD_CStream */
+    std::vector<char>       _out;               /**< compressed data before it is written */
+    std::thread             _thread;
+    std::mutex              _mutex;
+    std::condition_variable _changed;
+    std::vector<char>       _full;              /**< buffer handed over by the sink */
+    size_t                  _full_used;
+    bool                    _has_full;          /**< _full waits for or is being compressed */
+    bool                    _done;              /**< no more buffers follow */
+    std::atomic<bool>       _good;
+
+    void                    run();
+    bool                    compress(const char *data, const size_t n, const bool last);
+
+    // not copyable
+    Compressor(const Compressor& other);
+    Compressor& operator = (const Compressor& other);
+
+public:
+    Compressor():_file(NULL), _method(COMPRESSION_NONE), _stream(NULL), _full_used(0), _has_full(false), _done(false), _good(false) {}
+    ~Compressor();
+
+    bool                    start(FILE *file, const CompressionMethod method);
+    void                    push(std::vector<char>& buffer, const size_t used);
+    bool                    finish();
+    bool                    good() const {return _good;}
+};
+
+bool                        compression_available(const CompressionMethod method);
+bool                        parse_compression(const std::string& name, CompressionMethod& method);
+std::string                 compressed_name(const std::string& filename, const CompressionMethod method);
+
+#endif
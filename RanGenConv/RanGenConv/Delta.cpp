@@ -0,0 +1,88 @@
+//
+//  Delta.cpp
+//  RanGenConv
+//
+
+#include "Delta.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+/**
+ * @param base path of the base file
+ * @param variant number of the variant, starting with 1
+ * @return path of the variant's file
+ */
+std::string delta_variant_name(const std::string& base, const int variant) {
+    std::ostringstream name;
+    name<<base<<".v"<<variant;
+    return name.str();
+}
+
+/**
+ * @brief reconstructs the full .dat file of a variant written in delta mode
+ * @details the base is looked up in the directory of the variant. Lines of the variant are copied except "//!" directives, "//@ n" lines are replaced by the next n lines of the base.
+ *
+ * @param variant path of the variant's file
+ * @param ofilename path of the .dat file to write
+ * @return true if the file was reconstructed completely
+ */
+bool merge_delta(const char *variant, const char *ofilename) {
+    using namespace std;
+
+    ifstream vfile(variant, ios::binary);
+    if(!vfile.good()) {
+        cout<<"error: variant "<<variant<<" could not be opened"<<endl;
+        return false;
+    }
+
+    string line;
+    if(!getline(vfile, line) || line.compare(0, 9, "//! base ") != 0) {
+        cout<<"error: "<<variant<<" is not a variant written in delta mode"<<endl;
+        return false;
+    }
+    string path = variant;
+    size_t sep = path.find_last_of("/\\");
+    string basename = (sep == string::npos ? string() : path.substr(0, sep + 1)) + line.substr(9);
+
+    ifstream bfile(basename.c_str(), ios::binary);
+    if(!bfile.good()) {
+        cout<<"error: base "<<basename<<" could not be opened"<<endl;
+        return false;
+    }
+
+    OutputSink ofs;
+    if(!ofs.open(ofilename, true)) {
+        cout<<"error: output file could not been opened"<<endl;
+        return false;
+    }
+
+    bool res = true;
+    string shared;
+    while(res && getline(vfile, line)) {
+        if(line.compare(0, 3, "//!") == 0)continue;
+        if(line.compare(0, 4, "//@ ") == 0) {
+            long long n = atoll(line.c_str() + 4);
+            for(long long i = 0; i < n; i++) {
+                if(!getline(bfile, shared)) {
+                    cout<<"error: base "<<basename<<" ends before all shared statements of "<<variant<<" were read"<<endl;
+                    res = false;
+                    break;
+                }
+                ofs<<shared<<'\n';
+            }
+        }
+        else ofs<<line<<'\n';
+    }
+
+    if(!ofs.close() && res) {
+        cout<<"error: output file could not be written completely"<<endl;
+        res = false;
+    }
+    // no truncated file is left behind
+    if(!res)remove(ofilename);
+    return res;
+}
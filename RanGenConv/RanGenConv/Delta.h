@@ -0,0 +1,64 @@
+//
+//  Delta.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Delta_h
+#define RanGenConv_Delta_h
+
+#include "OutputSink.h"
+
+#include <string>
+
+/**
+ * @brief distributes the statements of a .dat file between a base file shared by several variants and the file of one variant
+ * @details the .dat writer asks for the sink of each statement. Statements which do not depend on the generated times (activities, capacities, relations, demands, ...) are shared: they are written once to the base and referenced in the variant by a line "//@ n" meaning "the next n lines of the base". The variant starts with "//! base <file>" and "//! seed <seed>". As all directives are comments, base and variant can be passed together to OPL as two data files, merge_delta reconstructs the full .dat byte by byte. Without a base, all statements go to one sink, i.e. a regular .dat file is written.
+ */
+class DeltaOutput {
+private:
+    OutputSink&             _variant;
+    OutputSink             *_base;          /**< sink for shared statements, NULL if they were written already */
+    bool                    _delta;         /**< false if a regular .dat file is written */
+    long long               _pending;       /**< shared statements not referenced in the variant yet */
+
+public:
+    DeltaOutput(OutputSink& out):_variant(out), _base(&out), _delta(false), _pending(0) {}
+    DeltaOutput(OutputSink& variant, OutputSink *base):_variant(variant), _base(base), _delta(true), _pending(0) {}
+
+    /**
+     * @brief announces statements shared by all variants
+     *
+     * @param statements number of statements (lines) about to be written
+     * @return sink to write them to, NULL if they must not be written as the base has been written already
+     */
+    OutputSink             *shared(const int statements = 1) {
+        if(_delta)_pending += statements;
+        return _base;
+    }
+
+    /**
+     * @brief announces statements depending on the generated times
+     * @return sink to write them to
+     */
+    OutputSink&             variant() {
+        if(_pending > 0) {
+            _variant<<"//@ "<<_pending<<'\n';
+            _pending = 0;
+        }
+        return _variant;
+    }
+
+    /**
+     * @brief references shared statements at the end of the file, call once all statements are written
+     * @return true if no errors occured so far
+     */
+    bool                    finish() {
+        variant();
+        return _variant.good() && (!_base || _base->good());
+    }
+};
+
+std::string                 delta_variant_name(const std::string& base, const int variant);
+bool                        merge_delta(const char *variant, const char *ofilename);
+
+#endif
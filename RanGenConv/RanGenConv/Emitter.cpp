@@ -0,0 +1,536 @@
+//
+//  Emitter.cpp
+//  RanGenConv
+//
+
+#include "Emitter.h"
+#include "helper.h"
+
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// values per chunk if fields are formatted in parallel
+#define EMIT_CHUNK_VALUES (1 << 15)
+
+/**
+ * @return true if name is followed by two spaces in the .dat layout
+ */
+static bool dat_wide_assignment(const char *name) {
+    static const char *names[] = {"maxProgress", "minProgress", "Relations", "release", "deadline", "window", "est", "lst"};
+    for(unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        if(strcmp(name, names[i]) == 0)return true;
+    return false;
+}
+
+bool DatEmitter::begin_field(const FieldInfo& field) {
+    // horizon is part of the compact layout only, but determines the number of periods
+    if(strcmp(field.name, "horizon") == 0) {
+        _horizon = field.lo;
+        if(!_compact)return false;
+    }
+
+    // capacities repeated per period depend on the horizon, i.e. differ between variants
+    const bool repeat = !_compact && strcmp(field.name, "res_capacity") == 0;
+    _ofs = field.shared && !repeat ? _out.shared() : &_out.variant();
+    if(!_ofs)return false;
+
+    OutputSink& ofs = *_ofs;
+    ofs<<field.name<<(dat_wide_assignment(field.name) ? "  = " : " = ");
+
+    _kind = field.kind;
+    _count = 0;
+    _written = 0;
+    _columns = field.columns > 0 ? field.columns : 1;
+    _sparse = false;
+    _repeat = repeat;
+
+    switch(field.kind) {
+        case FIELD_SCALAR:
+            ofs<<field.lo<<";"<<'\n';
+            return false;
+        case FIELD_RANGE:
+            if(_compact)ofs<<field.lo<<".."<<field.hi;
+            else {
+                ofs<<"{";
+                for(long long i = field.lo; i < field.hi; i++)ofs<<i<<",";
+                ofs<<field.hi<<"}";
+            }
+            ofs<<";"<<'\n';
+            return false;
+        case FIELD_ARRAY:
+            ofs<<"[";
+            _capacity.clear();
+            break;
+        case FIELD_MATRIX:
+            // compact output lists only positive entries as tuples <row, column, value>
+            _sparse = _compact;
+            ofs<<(_sparse ? "{" : "[");
+            break;
+        case FIELD_TUPLE_SET:
+            ofs<<"{";
+            break;
+        case FIELD_TUPLE_ARRAY:
+            ofs<<"[";
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief writes separators and brackets in front of the next value
+ */
+void DatEmitter::before_value() {
+    OutputSink& ofs = *_ofs;
+    switch(_kind) {
+        case FIELD_ARRAY:
+            if(_count > 0)ofs<<",";
+            break;
+        case FIELD_MATRIX:
+            if(_count % _columns == 0) {
+                if(_count > 0)ofs<<",";
+                ofs<<"[";
+            }
+            else ofs<<",";
+            break;
+        case FIELD_TUPLE_SET:
+        case FIELD_TUPLE_ARRAY:
+            if(_count % _columns == 0) {
+                if(_count > 0)ofs<<",";
+                ofs<<"<";
+            }
+            else ofs<<",";
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief closes rows and tuples after a value
+ */
+void DatEmitter::after_value() {
+    _count++;
+    if(_count % _columns != 0)return;
+    if(_kind == FIELD_MATRIX)*_ofs<<"]";
+    else if(_kind == FIELD_TUPLE_SET || _kind == FIELD_TUPLE_ARRAY)*_ofs<<">";
+}
+
+void DatEmitter::value(const long long v) {
+    if(_repeat) {
+        // capacities are written for each period once all are known
+        _capacity.push_back(v);
+        return;
+    }
+    if(_kind == FIELD_MATRIX && _sparse) {
+        if(v != 0) {
+            if(_written > 0)*_ofs<<",";
+            *_ofs<<"<"<<(_count / _columns + 1)<<","<<(_count % _columns + 1)<<","<<v<<">";
+            _written++;
+        }
+        _count++;
+        return;
+    }
+    before_value();
+    *_ofs<<v;
+    after_value();
+}
+
+void DatEmitter::value(const double v) {
+    before_value();
+    _ofs->write_double(v, 6);
+    after_value();
+}
+
+void DatEmitter::end_field(const FieldInfo& field) {
+    OutputSink& ofs = *_ofs;
+    if(_repeat) {
+        // (overall) resource capacity (constant) at each period
+        for(long long t = 1; t <= _horizon; t++) {
+            ofs<<"[";
+            for(size_t j = 0; j < _capacity.size(); j++) {
+                if(j > 0)ofs<<",";
+                ofs<<_capacity[j];
+            }
+            ofs<<"]"<<(t < _horizon ? "," : "");
+        }
+        _capacity.clear();
+    }
+    switch(field.kind) {
+        case FIELD_MATRIX:
+            ofs<<(_sparse ? "};" : "];")<<'\n';
+            break;
+        case FIELD_TUPLE_SET:
+            ofs<<"};"<<'\n';
+            break;
+        default:
+            ofs<<"];"<<'\n';
+            break;
+    }
+}
+
+bool DatEmitter::end_instance() {
+    return _out.finish();
+}
+
+FormatEmitter *DatEmitter::fork(OutputSink& buffer, const long long count) const {
+    DatEmitter *chunk = new DatEmitter(*this);
+    chunk->_ofs = &buffer;
+    chunk->_count = count;
+    return chunk;
+}
+
+void DatEmitter::append(const OutputSink& chunk, const long long values) {
+    _ofs->write(chunk.data(), chunk.size());
+    _count += values;
+}
+
+bool DznEmitter::begin_field(const FieldInfo& field) {
+    _ofs<<field.name<<" = ";
+    _count = 0;
+    switch(field.kind) {
+        case FIELD_SCALAR:
+            _ofs<<field.lo<<";"<<'\n';
+            return false;
+        case FIELD_RANGE:
+            _ofs<<field.lo<<".."<<field.hi<<";"<<'\n';
+            return false;
+        case FIELD_ARRAY:
+            _ofs<<"[";
+            break;
+        default:
+            _ofs<<"array2d(1.."<<field.size<<", 1.."<<field.columns<<", [";
+            break;
+    }
+    return true;
+}
+
+void DznEmitter::value(const long long v) {
+    if(_count++ > 0)_ofs<<",";
+    _ofs<<v;
+}
+
+void DznEmitter::value(const double v) {
+    if(_count++ > 0)_ofs<<",";
+    if(std::isinf(v))_ofs<<(v < 0 ? "-infinity" : "infinity");
+    else if(v == std::floor(v) && std::fabs(v) < 1e15)_ofs<<(long long)v<<".0";
+    else _ofs.write_double(v);
+}
+
+void DznEmitter::end_field(const FieldInfo& field) {
+    _ofs<<(field.kind == FIELD_ARRAY ? "];" : "]);")<<'\n';
+}
+
+bool DznEmitter::end_instance() {
+    return _ofs.good();
+}
+
+FormatEmitter *DznEmitter::fork(OutputSink& buffer, const long long count) const {
+    DznEmitter *chunk = new DznEmitter(buffer);
+    chunk->_count = count;
+    return chunk;
+}
+
+void DznEmitter::append(const OutputSink& chunk, const long long values) {
+    _ofs.write(chunk.data(), chunk.size());
+    _count += values;
+}
+
+void JsonEmitter::begin_instance() {
+    _ofs<<"{";
+    _first = true;
+}
+
+bool JsonEmitter::begin_field(const FieldInfo& field) {
+    _ofs<<(_first ? "\n" : ",\n")<<"  \""<<field.name<<"\": ";
+    _first = false;
+    _count = 0;
+    _columns = field.columns > 0 ? field.columns : 1;
+    _nested = field.kind == FIELD_MATRIX || field.kind == FIELD_TUPLE_SET || field.kind == FIELD_TUPLE_ARRAY;
+    switch(field.kind) {
+        case FIELD_SCALAR:
+            _ofs<<field.lo;
+            return false;
+        case FIELD_RANGE:
+            _ofs<<"{\"from\": "<<field.lo<<", \"to\": "<<field.hi<<"}";
+            return false;
+        default:
+            _ofs<<"[";
+            break;
+    }
+    return true;
+}
+
+void JsonEmitter::before_value() {
+    if(_nested && _count % _columns == 0) {
+        if(_count > 0)_ofs<<",";
+        _ofs<<"[";
+    }
+    else if(_count > 0)_ofs<<",";
+}
+
+void JsonEmitter::after_value() {
+    _count++;
+    if(_nested && _count % _columns == 0)_ofs<<"]";
+}
+
+void JsonEmitter::value(const long long v) {
+    before_value();
+    _ofs<<v;
+    after_value();
+}
+
+void JsonEmitter::value(const double v) {
+    before_value();
+    // JSON knows no infinity, e.g. maxProgress of activities without duration
+    if(std::isfinite(v))_ofs.write_double(v);
+    else _ofs<<"null";
+    after_value();
+}
+
+void JsonEmitter::end_field(const FieldInfo& /*field*/) {
+    _ofs<<"]";
+}
+
+bool JsonEmitter::end_instance() {
+    _ofs<<"\n}\n";
+    return _ofs.good();
+}
+
+FormatEmitter *JsonEmitter::fork(OutputSink& buffer, const long long count) const {
+    JsonEmitter *chunk = new JsonEmitter(buffer);
+    chunk->_first = _first;
+    chunk->_count = count;
+    chunk->_columns = _columns;
+    chunk->_nested = _nested;
+    return chunk;
+}
+
+void JsonEmitter::append(const OutputSink& chunk, const long long values) {
+    _ofs.write(chunk.data(), chunk.size());
+    _count += values;
+}
+
+/**
+ * @brief announces field to all emitters
+ *
+ * @param emitters all emitters
+ * @param field field to announce
+ * @param active set to the emitters which requested the field's values
+ * @return true if at least one emitter requested the values
+ */
+static bool begin_field(const std::vector<FormatEmitter *>& emitters, const FieldInfo& field, std::vector<FormatEmitter *>& active) {
+    active.clear();
+    for(std::vector<FormatEmitter *>::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
+        if((*it)->begin_field(field))active.push_back(*it);
+    return !active.empty();
+}
+
+template<typename T> static void put(const std::vector<FormatEmitter *>& active, const T v) {
+    for(std::vector<FormatEmitter *>::const_iterator it = active.begin(); it != active.end(); ++it)(*it)->value(v);
+}
+
+/**
+ * @brief passes values get(0), ..., get(count - 1) of the current field to all active emitters
+ * @details large fields are split into chunks of EMIT_CHUNK_VALUES values formatted on up to threads threads by emitters supporting it, the output is the same as passing the values one by one. get is called concurrently.
+ */
+template<typename T, typename F> static void put_values(const std::vector<FormatEmitter *>& active, const long long count, const int threads, F get) {
+    std::vector<FormatEmitter *> sequential;
+    for(std::vector<FormatEmitter *>::const_iterator it = active.begin(); it != active.end(); ++it) {
+        FormatEmitter *emitter = *it;
+        if(threads <= 1 || count < 2 * EMIT_CHUNK_VALUES || !emitter->parallel()) {
+            sequential.push_back(emitter);
+            continue;
+        }
+        format_chunked(count, threads, EMIT_CHUNK_VALUES, [&](long long begin, long long end, OutputSink& buffer) {
+            FormatEmitter *chunk = emitter->fork(buffer, begin);
+            for(long long i = begin; i < end; i++)chunk->value((T)get(i));
+            delete chunk;
+        }, [&](long long begin, long long end, const OutputSink& buffer) {
+            emitter->append(buffer, end - begin);
+        });
+    }
+    if(sequential.empty())return;
+    for(long long i = 0; i < count; i++)put(sequential, (T)get(i));
+}
+
+static void end_field(const std::vector<FormatEmitter *>& active, const FieldInfo& field, const bool verbose) {
+    for(std::vector<FormatEmitter *>::const_iterator it = active.begin(); it != active.end(); ++it)(*it)->end_field(field);
+    if(verbose)std::cout<<field.name<<" written..."<<std::endl;
+}
+
+/**
+ * @brief traverses an instance with generated times once and passes its fields to all emitters
+ * @details fields are passed in the order of the .dat layout: time, activity, resource, horizon, res_capacity, maxProgress, minProgress, Relations, release, deadline, window and window_vars (if windows), est, lst and cpl (if cpm) and res_demand. Activities are numbered starting with 1, ids are shifted by one if the dummy start is left out.
+ *
+ * @param file instance with generated times
+ * @param dummynodes set to true to include dummy start and end
+ * @param windows set to true to pass the feasible periods release + 1..deadline of each activity
+ * @param cpm set to true to pass the results of the critical path analysis
+ * @param cp_length critical path length
+ * @param emitters emitters to write the instance with
+ * @param verbose set to true to report each field
+ * @param threads number of threads to format the per activity fields with
+ * @return true if all emitters succeeded
+ */
+bool emit_instance(RanGenFile& file, const bool dummynodes, const bool windows, const bool cpm, const int cp_length,
+                   const std::vector<FormatEmitter *>& emitters, const bool verbose, const int threads) {
+    using namespace std;
+
+    const int offset = dummynodes ? 0 : 1;
+    const int first = offset, last = file.node_count() - offset; // activities are nodes [first, last)
+    const long long activity_count = last - first;
+    const int K = file.resource_count();
+    const int maxtime = file.horizon();
+    vector<FormatEmitter *> active;
+
+    for(vector<FormatEmitter *>::const_iterator it = emitters.begin(); it != emitters.end(); ++it)(*it)->begin_instance();
+
+    FieldInfo time("time", FIELD_RANGE, false);
+    time.lo = offset;
+    time.hi = maxtime;
+    begin_field(emitters, time, active);
+
+    FieldInfo activity("activity", FIELD_RANGE, true);
+    activity.lo = 1;
+    activity.hi = activity_count;
+    begin_field(emitters, activity, active);
+
+    FieldInfo resource("resource", FIELD_RANGE, true);
+    resource.lo = 1;
+    resource.hi = K;
+    begin_field(emitters, resource, active);
+
+    FieldInfo horizon("horizon", FIELD_SCALAR, false);
+    horizon.lo = maxtime;
+    begin_field(emitters, horizon, active);
+
+    FieldInfo capacity("res_capacity", FIELD_ARRAY, true);
+    capacity.size = K;
+    if(begin_field(emitters, capacity, active)) {
+        for(int k = 0; k < K; k++)put(active, (long long)file.resource_availability()[k]);
+        end_field(active, capacity, verbose);
+    }
+
+    // max progress is 1.0 / activity duration. Can be also something arbitrarily
+    // i.e. draw max progress as uniform random variable out of interval [0.2 1]
+    FieldInfo max_progress("maxProgress", FIELD_ARRAY, true);
+    max_progress.size = activity_count;
+    max_progress.real = true;
+    if(begin_field(emitters, max_progress, active)) {
+        put_values<double>(active, activity_count, threads, [&](long long i) {return 1.0 / file.nodes(first + (int)i).activity_duration + 0.000001;});
+        end_field(active, max_progress, verbose);
+    }
+
+    FieldInfo min_progress("minProgress", FIELD_ARRAY, true);
+    min_progress.size = activity_count;
+    min_progress.real = true;
+    if(begin_field(emitters, min_progress, active)) {
+        put_values<double>(active, activity_count, threads, [](long long /*i*/) {return 0.0;});
+        end_field(active, min_progress, verbose);
+    }
+
+    // relations, dummy relations are left out along with the dummies. Emitters need their number up front, which is derived from the degrees of the dummies instead of a pass over all edges
+    FieldInfo relations("Relations", FIELD_TUPLE_SET, true);
+    relations.columns = 2;
+    relations.size = file.edge_count();
+    if(!dummynodes) {
+        const vector<int>& start = file.successors(0);
+        relations.size -= (long long)(start.size() + file.predecessors(file.node_count() - 1).size());
+        if(binary_search(start.begin(), start.end(), file.node_count() - 1))relations.size++;
+    }
+    if(begin_field(emitters, relations, active)) {
+        for(RanGenFile::edge_iterator it = file.edges_begin(); it != file.edges_end(); ++it) {
+            if(!dummynodes && (it.source() == 0 || it.target() == file.node_count() - 1))continue;
+            put(active, (long long)(it.source() + 1 - offset));
+            put(active, (long long)(it.target() + 1 - offset));
+        }
+        end_field(active, relations, verbose);
+    }
+
+    FieldInfo release("release", FIELD_ARRAY, false);
+    release.size = activity_count;
+    if(begin_field(emitters, release, active)) {
+        put_values<long long>(active, activity_count, threads, [&](long long i) {return file.nodes(first + (int)i).release;});
+        end_field(active, release, verbose);
+    }
+
+    FieldInfo deadline("deadline", FIELD_ARRAY, false);
+    deadline.size = activity_count;
+    if(begin_field(emitters, deadline, active)) {
+        put_values<long long>(active, activity_count, threads, [&](long long i) {return file.nodes(first + (int)i).deadline;});
+        end_field(active, deadline, verbose);
+    }
+
+    // feasible periods of time-indexed models, an activity can be processed in period t (covering [t - 1, t)) iff release < t <= deadline
+    if(windows) {
+        FieldInfo window("window", FIELD_TUPLE_ARRAY, false);
+        window.size = activity_count;
+        window.columns = 2;
+        if(begin_field(emitters, window, active)) {
+            put_values<long long>(active, 2 * activity_count, threads, [&](long long i) {
+                const node& v = file.nodes(first + (int)(i / 2));
+                return i % 2 == 0 ? v.release + 1 : v.deadline;
+            });
+            end_field(active, window, verbose);
+        }
+
+        FieldInfo window_vars("window_vars", FIELD_SCALAR, false);
+        for(int i = first; i < last; i++)window_vars.lo += max(file.nodes(i).deadline - file.nodes(i).release, 0);
+        begin_field(emitters, window_vars, active);
+        if(verbose)cout<<window_vars.lo<<" of "<<(activity_count * maxtime)<<" activity x period variables ("
+            <<(100.0 * window_vars.lo / max(activity_count * maxtime, 1LL))<<"%)"<<endl;
+    }
+
+    // results of critical path analysis
+    if(cpm) {
+        FieldInfo est("est", FIELD_ARRAY, false);
+        est.size = activity_count;
+        if(begin_field(emitters, est, active)) {
+            put_values<long long>(active, activity_count, threads, [&](long long i) {return file.nodes(first + (int)i).est;});
+            end_field(active, est, verbose);
+        }
+
+        FieldInfo lst("lst", FIELD_ARRAY, false);
+        lst.size = activity_count;
+        if(begin_field(emitters, lst, active)) {
+            put_values<long long>(active, activity_count, threads, [&](long long i) {return file.nodes(first + (int)i).lst;});
+            end_field(active, lst, verbose);
+        }
+
+        FieldInfo cpl("cpl", FIELD_SCALAR, false);
+        cpl.lo = cp_length;
+        begin_field(emitters, cpl, active);
+    }
+
+    FieldInfo demand("res_demand", FIELD_MATRIX, true);
+    demand.size = activity_count;
+    demand.columns = K;
+    if(begin_field(emitters, demand, active)) {
+        put_values<long long>(active, activity_count * K, threads, [&](long long i) {
+            const vector<int>& req = file.nodes(first + (int)(i / K)).resource_requirements;
+            const int k = (int)(i % K);
+            return k < (int)req.size() ? req[k] : 0;
+        });
+        end_field(active, demand, verbose);
+    }
+
+    bool res = true;
+    for(vector<FormatEmitter *>::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
+        if(!(*it)->end_instance())res = false;
+    return res;
+}
+
+/**
+ * @brief creates an emitter for an additional output format
+ *
+ * @param format dzn or json
+ * @param out sink the emitter writes to
+ * @return new emitter, NULL if format is unknown
+ */
+FormatEmitter *create_emitter(const std::string& format, OutputSink& out) {
+    if(format == "dzn")return new DznEmitter(out);
+    if(format == "json")return new JsonEmitter(out);
+    return NULL;
+}
@@ -0,0 +1,169 @@
+//
+//  Emitter.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Emitter_h
+#define RanGenConv_Emitter_h
+
+#include "RanGenFile.h"
+#include "OutputSink.h"
+#include "Delta.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief shape of a field of an instance
+ */
+enum FieldKind {
+    FIELD_SCALAR = 0,                   /**< one integer given as lo, no values follow */
+    FIELD_RANGE,                        /**< contiguous set of integers lo..hi, no values follow */
+    FIELD_ARRAY,                        /**< size values */
+    FIELD_MATRIX,                       /**< size rows of columns values, row by row */
+    FIELD_TUPLE_SET,                    /**< size tuples of columns values each, unordered */
+    FIELD_TUPLE_ARRAY                   /**< size tuples of columns values each, one per activity */
+};
+
+/**
+ * @brief description of a field passed to the emitters before its values
+ */
+class FieldInfo {
+public:
+    const char             *name;
+    FieldKind               kind;
+    bool                    shared;     /**< true if the field does not depend on the generated times */
+    bool                    real;       /**< values are passed as double */
+    long long               size;       /**< number of elements, rows or tuples */
+    int                     columns;    /**< columns of a matrix, arity of tuples */
+    long long               lo;         /**< value of a scalar, lower bound of a range */
+    long long               hi;         /**< upper bound of a range */
+
+    FieldInfo(const char *name, const FieldKind kind, const bool shared):name(name), kind(kind), shared(shared), real(false), size(1), columns(1), lo(0), hi(0) {}
+};
+
+/**
+ * @brief output format consuming the fields of an instance
+ * @details emit_instance traverses the instance once and passes every field to all emitters: begin_field announces it, if the emitter returns true its values follow via value and the field is closed by end_field. Fields no emitter is interested in are not computed at all. Each emitter writes to its own sink.
+ * Emitters supporting parallel formatting return true from parallel for the current field. The values are then split into chunks, each formatted by an emitter obtained via fork writing to a buffer, and the buffers are passed to append in order.
+ */
+class FormatEmitter {
+public:
+    virtual ~FormatEmitter() {}
+
+    virtual void            begin_instance() {}
+    virtual bool            begin_field(const FieldInfo& field) = 0;
+    virtual void            value(const long long v) = 0;
+    virtual void            value(const double v) = 0;
+    virtual void            end_field(const FieldInfo& field) = 0;
+    virtual bool            end_instance() = 0;
+
+    /**
+     * @return true if the values of the current field may be formatted in chunks via fork
+     */
+    virtual bool            parallel() const {return false;}
+
+    /**
+     * @brief creates an emitter formatting the values of the current field starting with value count to buffer
+     */
+    virtual FormatEmitter  *fork(OutputSink& /*buffer*/, const long long /*count*/) const {return NULL;}
+
+    /**
+     * @brief writes a chunk formatted by a fork holding values values
+     */
+    virtual void            append(const OutputSink& /*chunk*/, const long long /*values*/) {}
+};
+
+/**
+ * @brief OPL .dat layout used by the Kis / Alfieri models' implementations
+ * @details statements are requested from a DeltaOutput, hence the emitter writes regular .dat files as well as delta variants. Without compact, sets are listed element by element and the capacities are repeated for each period.
+ */
+class DatEmitter : public FormatEmitter {
+private:
+    DeltaOutput&            _out;
+    OutputSink             *_ofs;           /**< sink of the current field */
+    bool                    _compact;
+    FieldKind               _kind;          /**< kind of the current field */
+    bool                    _sparse;        /**< current matrix is written as tuples of its nonzero entries */
+    long long               _horizon;
+    long long               _count;         /**< values of the current field so far */
+    long long               _written;       /**< entries of a sparse matrix written so far */
+    int                     _columns;
+    bool                    _repeat;        /**< current field holds the capacities, which are repeated per period without compact */
+    std::vector<long long>  _capacity;
+
+    void                    before_value();
+    void                    after_value();
+
+public:
+    DatEmitter(DeltaOutput& out, const bool compact):_out(out), _ofs(NULL), _compact(compact), _kind(FIELD_SCALAR), _sparse(false), _horizon(0), _count(0), _written(0), _columns(1), _repeat(false) {}
+
+    bool                    begin_field(const FieldInfo& field);
+    void                    value(const long long v);
+    void                    value(const double v);
+    void                    end_field(const FieldInfo& field);
+    bool                    end_instance();
+
+    bool                    parallel() const {return !_repeat && !_sparse;}
+    FormatEmitter          *fork(OutputSink& buffer, const long long count) const;
+    void                    append(const OutputSink& chunk, const long long values);
+};
+
+/**
+ * @brief MiniZinc .dzn layout
+ * @details sets are written as ranges, matrices and tuples as array2d, real values always contain a decimal point.
+ */
+class DznEmitter : public FormatEmitter {
+private:
+    OutputSink&             _ofs;
+    long long               _count;
+
+public:
+    DznEmitter(OutputSink& out):_ofs(out), _count(0) {}
+
+    bool                    begin_field(const FieldInfo& field);
+    void                    value(const long long v);
+    void                    value(const double v);
+    void                    end_field(const FieldInfo& field);
+    bool                    end_instance();
+
+    bool                    parallel() const {return true;}
+    FormatEmitter          *fork(OutputSink& buffer, const long long count) const;
+    void                    append(const OutputSink& chunk, const long long values);
+};
+
+/**
+ * @brief JSON object with one member per field
+ * @details ranges are written as {"from": lo, "to": hi}, matrices and tuples as arrays of arrays.
+ */
+class JsonEmitter : public FormatEmitter {
+private:
+    OutputSink&             _ofs;
+    bool                    _first;         /**< no member written yet */
+    long long               _count;
+    int                     _columns;
+    bool                    _nested;        /**< values are grouped into inner arrays */
+
+    void                    before_value();
+    void                    after_value();
+
+public:
+    JsonEmitter(OutputSink& out):_ofs(out), _first(true), _count(0), _columns(1), _nested(false) {}
+
+    void                    begin_instance();
+    bool                    begin_field(const FieldInfo& field);
+    void                    value(const long long v);
+    void                    value(const double v);
+    void                    end_field(const FieldInfo& field);
+    bool                    end_instance();
+
+    bool                    parallel() const {return true;}
+    FormatEmitter          *fork(OutputSink& buffer, const long long count) const;
+    void                    append(const OutputSink& chunk, const long long values);
+};
+
+bool                        emit_instance(RanGenFile& file, const bool dummynodes, const bool windows, const bool cpm, const int cp_length,
+                                          const std::vector<FormatEmitter *>& emitters, const bool verbose = false, const int threads = 1);
+FormatEmitter              *create_emitter(const std::string& format, OutputSink& out);
+
+#endif
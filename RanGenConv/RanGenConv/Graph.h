@@ -12,136 +12,75 @@
 #include "helper.h"
 
 #include <stack>
+#include <algorithm>
 #include <vector>
 #include <cassert>
 #include <stdio.h>
-
-/**
- * @brief stores graph structure as adjacency matrix
- * @details stores graph structure as adjacency matrix based on unsigned chars. Values > 0 indicate that edge exists.
- * 
- */
-class Adjacencymatrix {
-private:
-    int num_nodes;
-    unsigned char *adj; 
-    
-    void clear() {
-        if (adj)delete[] adj;
-        adj = NULL;
-        num_nodes = 0;
-    }
-public:
-    Adjacencymatrix() : num_nodes(0), adj(NULL) {
-        
-    }
-    ~Adjacencymatrix() {
-        clear();
-    }
-    
-    /**
-     * @brief sets entry in adjacency matrix to val. Positive values of val indicate edge <i, j> is part of edge set.
-     * 
-     * @param i predecessor
-     * @param j successor
-     * @param val 0 indicates <i, j> not part of edge set, values != 0 part of edge set
-     */
-    void set(const unsigned int i, const unsigned int j, const unsigned char val) {
-        assert(adj);
-        assert(0 <= i && 0 <= j && i < num_nodes && j < num_nodes);
-        adj[i + j * num_nodes] = val;
-    }
-    
-    /**
-     * @brief returns positive values if edge <i, j> is contained in edge set
-     * 
-     * @param i predecessor
-     * @param j successor
-     * 
-     * @return positive values if edge <i, h> is part of edge set
-     */
-    unsigned char get(const int i, const int j) {
-        assert(adj);
-        return adj[i + j * num_nodes];
-    }
-    
-    /**
-     * @brief reserves space for the adjacency matrix
-     * 
-     * @param _num_nodes number of nodes to reserve space for
-     */
-    void create(const int _num_nodes) {
-        if (adj)clear();
-        num_nodes = _num_nodes;
-        adj = new unsigned char[num_nodes * num_nodes];
-        for (int i = 0; i < num_nodes * num_nodes; i++)adj[i] = 0;
-    }
-    
-    /**
-     * @return number of nodes of the representation (not the by edge structure actual implicitly contained ones of the graph)
-     */
-    int node_count() { return num_nodes; }
-};
+#include <string.h>
 
 /**
  * @brief handles storage of graph structure and assigned data to nodes
- * @details uses currently an adjacencymatrix for representation of edge structure, an adjancency list might be an alternative. Supports only data assigned to vertices.
+ * @details represents the edge structure by sorted successor and predecessor lists, i.e. memory and traversals take O(V + E). Supports only data assigned to vertices.
  * @tparam T type of the data assigned to the individual nodes 
  */
 template<typename T> class Graph {
     T *_vertices; // stores all information regarding nodes
     unsigned int _vertex_count; // number of vertices
-    //std::vector<Edge> _adjList; // adjacency list
-    Adjacencymatrix _m; // adjacency matrix
+    std::vector<std::vector<int> > _succ; // successor lists
+    std::vector<std::vector<int> > _pred; // predecessor lists
+    unsigned int _edge_count; // number of edges
     
-    bool validIndex(int i) {
+    bool validIndex(int i) const {
         return 0 <= i && i < _vertex_count;
     }
     
-    // helper function to check if graph contains cycles
-    bool isCyclicUtil(int v, bool *visited, bool *recStack) {
-        assert(visited);
-        assert(recStack);
+public:
+    /**
+     * @brief iterates over all edges <i, j> in ascending order of i, then j
+     * @details visits only existing edges using the successor lists, i.e. a full iteration takes O(V + E). Invalidated if edges are added or removed.
+     */
+    class edge_iterator {
+        const std::vector<std::vector<int> > *_succ;
+        unsigned int _i; // current predecessor
+        unsigned int _k; // position in successor list of _i
         
-        if (!visited[v]) {
-            //mark current node as visited, push on stack
-            visited[v] = true;
-            recStack[v] = true;
-            
-            for (int i = 0; i < _m.node_count(); i++) {
-                
-                // skip non-adjacent nodes
-                if (!_m.get(v, i))continue;
-                
-                // check for all adjacent nodes, if they will lead to a back edge!
-                if (!visited[i] && isCyclicUtil(i, visited, recStack))
-                    return true;
-                else if (recStack[i])
-                    return true;
+        // moves forward to the next vertex having successors left
+        void skip() {
+            while(_i < _succ->size() && _k >= (*_succ)[_i].size()) {
+                _i++;
+                _k = 0;
             }
         }
-        recStack[v] = false; // remove from stack
-        return false;
-    }
-    
-    // helper for topological sorting
-    void topolocialSortUtil(const int v, bool *visited, std::stack<int>& Stack) {
-        // mark current node as visited
-        visited[v] = true;
+    public:
+        edge_iterator(const std::vector<std::vector<int> > *succ, const unsigned int i):_succ(succ), _i(i), _k(0) {
+            skip();
+        }
         
-        // go through all adjacent vertices
-        for (int i = 0; i < vertex_count(); i++) {
-            if (!get(v, i))continue; // skip non-adjacent vertices
-            
-            if (!visited[i])
-                topolocialSortUtil(i, visited, Stack);
+        /**
+         * @return predecessor i of current edge <i, j>
+         */
+        int source() const {return (int)_i;}
+        
+        /**
+         * @return successor j of current edge <i, j>
+         */
+        int target() const {return (*_succ)[_i][_k];}
+        
+        edge_iterator& operator ++ () {
+            _k++;
+            skip();
+            return *this;
         }
         
-        // push vertex to stack to store result
-        Stack.push(v);
+        bool operator == (const edge_iterator& other) const {return _i == other._i && _k == other._k;}
+        bool operator != (const edge_iterator& other) const {return !(*this == other);}
+    };
+    
+    Graph():_vertices(NULL), _vertex_count(0), _edge_count(0) {}
+    
+    Graph(const Graph& other):_vertices(NULL), _vertex_count(0), _edge_count(0) {
+        *this = other;
     }
-public:
-    Graph():_vertices(NULL), _vertex_count(0) {}
     
     ~Graph() {
         if(_vertices) delete [] _vertices;
@@ -149,6 +88,28 @@ public:
         _vertex_count = 0;
     }
     
+    /**
+     * @brief deep copy of another graph
+     * @details copies edge structure and node data. Used i.e. to give each worker thread its own graph to generate times on.
+     * 
+     * @param other graph to copy
+     * @return reference to this graph
+     */
+    Graph& operator = (const Graph& other) {
+        if(this == &other)return *this;
+        if(_vertices) delete [] _vertices;
+        _vertices = NULL;
+        _vertex_count = other._vertex_count;
+        if(other._vertices) {
+            _vertices = new T[_vertex_count];
+            for(unsigned int i = 0; i < _vertex_count; i++)_vertices[i] = other._vertices[i];
+        }
+        _succ = other._succ;
+        _pred = other._pred;
+        _edge_count = other._edge_count;
+        return *this;
+    }
+    
     /**
      * @brief reserves space to store vertex_count vertices with data
      * @details reserves space to store vertex_count vertices with data. If called more than one time for the same Graph object, existing data will be deleted and the object be reset
@@ -161,7 +122,9 @@ public:
         _vertex_count = vertex_count;
         _vertices = new T[_vertex_count];
         
-        _m.create(_vertex_count);
+        _succ.assign(_vertex_count, std::vector<int>());
+        _pred.assign(_vertex_count, std::vector<int>());
+        _edge_count = 0;
         
         return true;
         
@@ -169,49 +132,47 @@ public:
     
     /**
      * @brief checks if graph is cyclic
-     * @details checks if graph is cyclic by performing a DFS (depth first search). For a DAG (directed acyclic graph) this function should return always false.
+     * @details checks if graph is cyclic via topologicalOrder in O(V + E). For a DAG (directed acyclic graph) this function should return always false.
      * @return true if cycle was found, false otherwise.
      */
-    bool isCyclic() {
-        bool res = false;
-        bool *visited = new bool[_m.node_count()];
-        bool *recStack = new bool[_m.node_count()];
-        
-        for (int i = 0; i < _m.node_count(); i++) {
-            visited[i] = recStack[i] = false;
-        }
-        
-        // call helper function to perform recursive dfs search
-        for (int i = 0; i < _m.node_count(); i++) {
-            if (isCyclicUtil(i, visited, recStack)) {
-                res = true;
-                break;
-            }
-        }
-        
-        delete[] visited;
-        delete[] recStack;
-        
-        return res;
+    bool isCyclic() const {
+        std::vector<int> order;
+        return !topologicalOrder(order);
     }
     
     /**
      * @brief performs a topological sort and outputs result on a stack
-     * @details performs a topological sort and outputs result on a stack using a DFS (depth first search).
+     * @details performs a topological sort and outputs result on a stack using a DFS (depth first search) visiting successors in ascending order. The DFS keeps its own stack, hence long paths do not overflow the call stack. Takes O(V + E). Requires an acyclic graph.
      * 
      * @param Stack C++ STL stack to write order of topological sort. I.e. first/top entry equals the first node which shall be visited.
      */
-    void topologicalSort(std::stack<int>& Stack) {
+    void topologicalSort(std::stack<int>& Stack) const {
         
-        bool *visited = new bool[vertex_count()];
-        for (int i = 0; i < vertex_count(); i++) {
-            visited[i] = false;
-        }
+        std::vector<bool> visited(_vertex_count, false);
         
-        // call helper to store topological sort on stack
-        for (int i = 0; i < vertex_count(); i++)
-            if (!visited[i])
-                topolocialSortUtil(i, visited, Stack);
+        // vertices on the DFS path along with the position in their successor list
+        std::vector<std::pair<int, size_t> > path;
+        for (unsigned int i = 0; i < _vertex_count; i++) {
+            if (visited[i])continue;
+            visited[i] = true;
+            path.push_back(std::make_pair((int)i, (size_t)0));
+            while (!path.empty()) {
+                const int v = path.back().first;
+                const std::vector<int>& s = _succ[v];
+                if (path.back().second < s.size()) {
+                    const int j = s[path.back().second++];
+                    if (!visited[j]) {
+                        visited[j] = true;
+                        path.push_back(std::make_pair(j, (size_t)0));
+                    }
+                }
+                else {
+                    // all successors done, push vertex to stack to store result
+                    Stack.push(v);
+                    path.pop_back();
+                }
+            }
+        }
     }
     
     //
@@ -253,7 +214,70 @@ public:
      */
     void set(const int i, const int j, const unsigned char val) {
         assert(validIndex(i) && validIndex(j));
-        _m.set(i, j, val);
+        
+        // adjacency lists are sorted ascending
+        std::vector<int>::iterator s = std::lower_bound(_succ[i].begin(), _succ[i].end(), j);
+        const bool exists = s != _succ[i].end() && *s == j;
+        if(val && !exists) {
+            _succ[i].insert(s, j);
+            _pred[j].insert(std::lower_bound(_pred[j].begin(), _pred[j].end(), i), i);
+            _edge_count++;
+        }
+        else if(!val && exists) {
+            _succ[i].erase(s);
+            _pred[j].erase(std::lower_bound(_pred[j].begin(), _pred[j].end(), i));
+            _edge_count--;
+        }
+    }
+    
+    /**
+     * @brief returns all successors of vertex #v
+     * 
+     * @param v index of node
+     * @return indices of all j with edge <v, j> in ascending order
+     */
+    const std::vector<int>& successors(const int v) const {
+        assert(0 <= v && v < (int)_vertex_count);
+        return _succ[v];
+    }
+    
+    /**
+     * @brief returns all predecessors of vertex #v
+     * 
+     * @param v index of node
+     * @return indices of all i with edge <i, v> in ascending order
+     */
+    const std::vector<int>& predecessors(const int v) const {
+        assert(0 <= v && v < (int)_vertex_count);
+        return _pred[v];
+    }
+    
+    /**
+     * @brief computes a topological order in O(V + E)
+     * @details uses Kahn's algorithm on the adjacency lists. Among vertices becoming available at the same time, lower indices come first.
+     * 
+     * @param order vector to write the order to. Contains less than vertex_count entries iff the graph has a cycle.
+     * @return true if graph is acyclic, i.e. order contains all vertices
+     */
+    bool topologicalOrder(std::vector<int>& order) const {
+        order.clear();
+        order.reserve(_vertex_count);
+        
+        std::vector<int> indegree(_vertex_count, 0);
+        for (unsigned int v = 0; v < _vertex_count; v++)
+            indegree[v] = (int)_pred[v].size();
+        
+        for (unsigned int v = 0; v < _vertex_count; v++)
+            if (indegree[v] == 0)order.push_back(v);
+        
+        // order doubles as queue
+        for (unsigned int head = 0; head < order.size(); head++) {
+            const std::vector<int>& s = _succ[order[head]];
+            for (std::vector<int>::const_iterator it = s.begin(); it != s.end(); ++it)
+                if (--indegree[*it] == 0)order.push_back(*it);
+        }
+        
+        return order.size() == _vertex_count;
     }
     /**
      * @brief returns whether edge belongs to edge set or not
@@ -264,9 +288,9 @@ public:
      * 
      * @return positive values mean edge belongs to edge set, 0 otherwise not.
      */
-    unsigned char get(const int i, const int j) {
+    unsigned char get(const int i, const int j) const {
         assert(validIndex(i) && validIndex(j));
-        return _m.get(i, j);
+        return std::binary_search(_succ[i].begin(), _succ[i].end(), j) ? 1 : 0;
     }
 
     /**
@@ -275,6 +299,21 @@ public:
      */
     unsigned int vertex_count() {return _vertex_count;}
     
+    /**
+     * @return number of edges of the graph
+     */
+    unsigned int edge_count() const {return _edge_count;}
+    
+    /**
+     * @return iterator to the first edge
+     */
+    edge_iterator edges_begin() const {return edge_iterator(&_succ, 0);}
+    
+    /**
+     * @return iterator past the last edge
+     */
+    edge_iterator edges_end() const {return edge_iterator(&_succ, (unsigned int)_succ.size());}
+    
 };
 
 
@@ -0,0 +1,146 @@
+//
+//  Manifest.cpp
+//  RanGenConv
+//
+
+#include "Manifest.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+Manifest::~Manifest() {
+    if(_journal)fclose(_journal);
+}
+
+/**
+ * @brief reads the manifest of an output directory
+ * @details a missing manifest is treated as empty. Lines which cannot be parsed, e.g. the last line of an interrupted run, are ignored.
+ *
+ * @param directory output directory of the batch
+ * @return false if the manifest exists but could not be read
+ */
+bool Manifest::load(const std::string& directory) {
+    using namespace std;
+
+    _path = directory + "/" + MANIFEST_NAME;
+    _entries.clear();
+    _has_seed = false;
+
+    ifstream ifs(_path.c_str());
+    if(!ifs)return true;
+
+    for(string line; getline(ifs, line); ) {
+        vector<string> fields;
+        stringstream ss(line);
+        for(string field; getline(ss, field, '\t'); )fields.push_back(field);
+        if(fields.size() == 2 && fields[0] == "seed") {
+            _seed = (unsigned int)strtoul(fields[1].c_str(), NULL, 10);
+            _has_seed = true;
+        }
+        else if(fields.size() == 5 && fields[0] == "+")_entries[fields[1]] = ManifestEntry(fields[2], fields[3], fields[4]);
+        else if(fields.size() == 2 && fields[0] == "-")_entries.erase(fields[1]);
+    }
+    return !ifs.bad();
+}
+
+/**
+ * @brief opens the manifest for recording outputs
+ *
+ * @param seed base seed of the batch
+ * @return false if the manifest could not be opened for writing
+ */
+bool Manifest::begin(const unsigned int seed) {
+    _journal = fopen(_path.c_str(), "a");
+    if(!_journal)return false;
+    if(_has_seed && _seed == seed)return true;
+    _seed = seed;
+    _has_seed = true;
+    std::ostringstream line;
+    line<<"seed\t"<<seed<<'\n';
+    return append(line.str());
+}
+
+bool Manifest::append(const std::string& line) {
+    // each line is complete on disk before the next output is converted
+    return _journal && fwrite(line.data(), 1, line.size(), _journal) == line.size() && fflush(_journal) == 0;
+}
+
+/**
+ * @return true if output was generated from the same input, parameters and version as given by entry, may be called concurrently
+ */
+bool Manifest::unchanged(const std::string& output, const ManifestEntry& entry) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<std::string, ManifestEntry>::const_iterator it = _entries.find(output);
+    return it != _entries.end() && it->second == entry;
+}
+
+/**
+ * @brief records that output was generated as described by entry, may be called concurrently
+ */
+bool Manifest::record(const std::string& output, const ManifestEntry& entry) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[output] = entry;
+    return append("+\t" + output + "\t" + entry.input_hash + "\t" + entry.version + "\t" + entry.parameters + "\n");
+}
+
+/**
+ * @brief records that output is missing or incomplete, may be called concurrently
+ */
+bool Manifest::remove(const std::string& output) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_entries.erase(output) == 0)return true;
+    return append("-\t" + output + "\n");
+}
+
+/**
+ * @brief rewrites the manifest with one line per output
+ * @details the new manifest is written next to the old one and renamed, hence the journal stays valid if writing fails
+ * @return true if the manifest was written successfully
+ */
+bool Manifest::close() {
+    using namespace std;
+
+    if(!_journal)return true;
+    bool res = fclose(_journal) == 0;
+    _journal = NULL;
+
+    string tmp = _path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "w");
+    if(!f)return false;
+    if(_has_seed)fprintf(f, "seed\t%u\n", _seed);
+    for(map<string, ManifestEntry>::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+        fprintf(f, "+\t%s\t%s\t%s\t%s\n", it->first.c_str(), it->second.input_hash.c_str(), it->second.version.c_str(), it->second.parameters.c_str());
+    if(fclose(f) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+#if defined(WIN32) || defined(_WIN32)
+    // rename does not replace existing files on Windows
+    std::remove(_path.c_str());
+#endif
+    return std::rename(tmp.c_str(), _path.c_str()) == 0 && res;
+}
+
+/**
+ * @brief 64bit FNV-1a hash of n bytes
+ */
+unsigned long long fnv1a(const char *data, const size_t n) {
+    unsigned long long h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief content hash of an instance as recorded in the manifest
+ * @return FNV-1a hash of the bytes and their number as hex string
+ */
+std::string content_hash(const char *data, const size_t n) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%016llx-%llu", fnv1a(data, n), (unsigned long long)n);
+    return buf;
+}
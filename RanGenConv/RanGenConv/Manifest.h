@@ -0,0 +1,78 @@
+//
+//  Manifest.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Manifest_h
+#define RanGenConv_Manifest_h
+
+#include <cstdio>
+#include <string>
+#include <map>
+#include <mutex>
+
+// name of the manifest within the output directory of a batch
+#define MANIFEST_NAME "rangenconv.manifest"
+
+/**
+ * @brief what an output of a batch was generated from
+ */
+class ManifestEntry {
+public:
+    std::string             input_hash;         /**< content hash of the instance, see content_hash */
+    std::string             version;            /**< RANGENCONV_VERSION of the converter */
+    std::string             parameters;         /**< canonical description of all options affecting the output, including the seed */
+
+    ManifestEntry() {}
+    ManifestEntry(const std::string& input_hash, const std::string& version, const std::string& parameters) : input_hash(input_hash), version(version), parameters(parameters) {}
+
+    bool                    operator == (const ManifestEntry& other) const {
+        return input_hash == other.input_hash && version == other.version && parameters == other.parameters;
+    }
+};
+
+/**
+ * @brief records per output of a batch the input hash, parameters and converter version it was generated with
+ * @details the manifest is a text file in the output directory. It is written as a journal: each finished output appends a line, later lines override earlier ones, so an interrupted batch keeps the outputs finished so far. close rewrites the file with one line per output. Lines are
+ *
+ * seed <base seed>
+ * + <output> <input hash> <version> <parameters>
+ * - <output>
+ *
+ * with fields separated by tabs, where - marks an output which failed and has to be regenerated.
+ */
+class Manifest {
+private:
+    std::string             _path;
+    std::map<std::string, ManifestEntry> _entries;
+    bool                    _has_seed;
+    unsigned int            _seed;
+    FILE                   *_journal;
+    mutable std::mutex      _mutex;             /**< guards _entries and the journal, record and remove are called by the workers of a batch */
+
+    bool                    append(const std::string& line);
+
+    // not copyable
+    Manifest(const Manifest& other);
+    Manifest& operator = (const Manifest& other);
+
+public:
+    Manifest():_has_seed(false), _seed(0), _journal(NULL) {}
+    ~Manifest();
+
+    bool                    load(const std::string& directory);
+    bool                    begin(const unsigned int seed);
+    bool                    unchanged(const std::string& output, const ManifestEntry& entry) const;
+    bool                    record(const std::string& output, const ManifestEntry& entry);
+    bool                    remove(const std::string& output);
+    bool                    close();
+
+    bool                    has_seed() const {return _has_seed;}
+    unsigned int            seed() const {return _seed;}
+    size_t                  size() const {std::lock_guard<std::mutex> lock(_mutex); return _entries.size();}
+};
+
+std::string                 content_hash(const char *data, const size_t n);
+unsigned long long          fnv1a(const char *data, const size_t n);
+
+#endif
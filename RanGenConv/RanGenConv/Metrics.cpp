@@ -0,0 +1,322 @@
+//
+//  Metrics.cpp
+//  RanGenConv
+//
+
+#include "Metrics.h"
+#include "helper.h"
+
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+typedef unsigned long long word_t;
+
+/**
+ * @brief number of set bits of a 64bit word
+ */
+static inline int popcount(word_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+
+/**
+ * @return minimum resource strength over all resources, 0 if there are none
+ */
+double InstanceMetrics::min_resource_strength() const {
+    if(resource_strength.empty())return 0.0;
+    return *std::min_element(resource_strength.begin(), resource_strength.end());
+}
+
+/**
+ * @return average resource strength over all resources, 0 if there are none
+ */
+double InstanceMetrics::mean_resource_strength() const {
+    if(resource_strength.empty())return 0.0;
+    double sum = 0.0;
+    for(unsigned int k = 0; k < resource_strength.size(); k++)sum += resource_strength[k];
+    return sum / resource_strength.size();
+}
+
+/**
+ * @brief writes the column names matching print_csv
+ */
+void InstanceMetrics::print_csv_header(OutputSink& out) {
+    out<<"instance,activities,resources,arcs,cnc,os,rf,rs_min,rs_mean,levels,max_width,sp,cpl\n";
+}
+
+/**
+ * @brief writes metrics as one CSV row, the instance path is quoted
+ */
+void InstanceMetrics::print_csv(OutputSink& out) const {
+    out<<'"';
+    for(std::string::const_iterator it = instance.begin(); it != instance.end(); ++it) {
+        if(*it == '"')out<<'"';
+        out<<*it;
+    }
+    out<<"\","<<activities<<','<<resources<<','<<arcs<<','<<cnc<<','<<order_strength<<','<<resource_factor<<','
+    <<min_resource_strength()<<','<<mean_resource_strength()<<','<<levels<<','<<max_width<<','<<serial_parallel<<','<<cpl<<'\n';
+}
+
+/**
+ * @brief writes metrics as one JSON object on a single line, i.e. a file of such rows is in JSON Lines format
+ */
+void InstanceMetrics::print_json(OutputSink& out) const {
+    out<<"{\"instance\":\"";
+    for(std::string::const_iterator it = instance.begin(); it != instance.end(); ++it) {
+        if(*it == '"' || *it == '\\')out<<'\\';
+        out<<*it;
+    }
+    out<<"\",\"activities\":"<<activities<<",\"resources\":"<<resources<<",\"arcs\":"<<arcs<<",\"cnc\":"<<cnc
+    <<",\"os\":"<<order_strength<<",\"rf\":"<<resource_factor<<",\"rs\":[";
+    for(unsigned int k = 0; k < resource_strength.size(); k++) {
+        if(k > 0)out<<',';
+        out<<resource_strength[k];
+    }
+    out<<"],\"levels\":"<<levels<<",\"max_width\":"<<max_width<<",\"sp\":"<<serial_parallel<<",\"cpl\":"<<cpl<<"}\n";
+}
+
+/**
+ * @brief computes network and resource characteristics of a parsed instance
+ * @details the order strength is obtained from the transitive closure, which is built as one bitset of descendants per node. Nodes are processed bucketed by their height (longest path to a sink), hence all nodes of a bucket only read bitsets of lower buckets and are processed in parallel. Resource strength follows Kolisch et al.: RS_k = (R_k - r_k^min) / (r_k^max - r_k^min) with r_k^min the largest single demand and r_k^max the peak demand of the earliest start schedule, RS_k = 1 if both coincide. Node 0 and the last node are treated as dummies.
+ *
+ * @param file parsed input file
+ * @param threads number of threads to use
+ * @param metrics metrics to fill, instance is left untouched
+ * @return true if no errors occured
+ */
+bool compute_metrics(RanGenFile& file, const int threads, InstanceMetrics& metrics) {
+    using namespace std;
+
+    const int n = (int)file.node_count();
+    const int K = (int)file.resource_count();
+    if(n < 2 || threads <= 0)return false;
+
+    const int J = n - 2;
+    const int first = 1, last = n - 2; // range of non-dummy activities
+
+    metrics.ok = false;
+    metrics.activities = J;
+    metrics.resources = K;
+
+    // arcs & CNC
+    long long arcs = 0;
+    for(int i = 0; i < n; i++)arcs += file.successors(i).size();
+    metrics.arcs = (int)arcs;
+    metrics.cnc = arcs / (double)n;
+
+    vector<int> order;
+    if(!file.topological_order(order))return false;
+
+    // progressive levels, dummies do not count as a level
+    vector<int> level(n, 0);
+    for(vector<int>::const_iterator it = order.begin(); it != order.end(); ++it) {
+        const vector<int>& p = file.predecessors(*it);
+        int l = 0;
+        for(vector<int>::const_iterator jt = p.begin(); jt != p.end(); ++jt)l = max(l, level[*jt]);
+        level[*it] = (*it == 0 || *it == n - 1) ? l : l + 1;
+    }
+    metrics.levels = 0;
+    for(int j = first; j <= last; j++)metrics.levels = max(metrics.levels, level[j]);
+    vector<int> width(metrics.levels + 1, 0);
+    for(int j = first; j <= last; j++)width[level[j]]++;
+    metrics.max_width = J > 0 ? *max_element(width.begin(), width.end()) : 0;
+    metrics.serial_parallel = J > 1 ? (metrics.levels - 1) / (double)(J - 1) : 1.0;
+
+    // order strength via bitset closure, bucket nodes by height
+    if(J > 1) {
+        const size_t W = (n + 63) / 64;
+        vector<word_t> reach(W * n, 0);
+
+        vector<int> height(n, 0);
+        int max_height = 0;
+        for(vector<int>::const_reverse_iterator it = order.rbegin(); it != order.rend(); ++it) {
+            const vector<int>& s = file.successors(*it);
+            int h = 0;
+            for(vector<int>::const_iterator jt = s.begin(); jt != s.end(); ++jt)h = max(h, height[*jt] + 1);
+            height[*it] = h;
+            max_height = max(max_height, h);
+        }
+
+        // counting sort of nodes by height
+        vector<int> bucket_start(max_height + 2, 0), by_height(n);
+        for(int i = 0; i < n; i++)bucket_start[height[i] + 1]++;
+        for(int h = 0; h <= max_height; h++)bucket_start[h + 1] += bucket_start[h];
+        {
+            vector<int> pos(bucket_start.begin(), bucket_start.end() - 1);
+            for(int i = 0; i < n; i++)by_height[pos[height[i]]++] = i;
+        }
+
+        vector<long long> pairs(n, 0);
+        for(int h = 0; h <= max_height; h++) {
+            const int begin = bucket_start[h];
+            parallel_for(bucket_start[h + 1] - begin, threads, max(1, 4096 / (int)W), [&](int b, int e) {
+                for(int k = begin + b; k < begin + e; k++) {
+                    const int i = by_height[k];
+                    word_t *r = &reach[W * i];
+                    const vector<int>& s = file.successors(i);
+                    for(vector<int>::const_iterator jt = s.begin(); jt != s.end(); ++jt) {
+                        const word_t *q = &reach[W * *jt];
+                        for(size_t w = 0; w < W; w++)r[w] |= q[w];
+                        // dummy end is no activity
+                        if(*jt != n - 1)r[*jt >> 6] |= 1ULL << (*jt & 63);
+                    }
+                    if(i != 0 && i != n - 1) {
+                        long long c = 0;
+                        for(size_t w = 0; w < W; w++)c += popcount(r[w]);
+                        pairs[i] = c;
+                    }
+                }
+            });
+        }
+
+        long long total = 0;
+        for(int i = first; i <= last; i++)total += pairs[i];
+        metrics.order_strength = total / (J * (J - 1) / 2.0);
+    }
+    else metrics.order_strength = 0.0;
+
+    vector<int> est, lst;
+    metrics.cpl = file.critical_path(est, lst);
+
+    // resource factor and strength, one resource per chunk
+    vector<long long> requested(K, 0);
+    metrics.resource_strength.assign(K, 1.0);
+    parallel_for(K, threads, 1, [&](int b, int e) {
+        for(int k = b; k < e; k++) {
+            int r_min = 0;
+            vector<pair<int, int> > events; // (time, demand change) of earliest start schedule
+            for(int j = first; j <= last; j++) {
+                node& a = file.nodes(j);
+                int r = k < (int)a.resource_requirements.size() ? a.resource_requirements[k] : 0;
+                if(r <= 0)continue;
+                requested[k]++;
+                r_min = max(r_min, r);
+                if(a.activity_duration > 0) {
+                    events.push_back(make_pair(est[j], r));
+                    events.push_back(make_pair(est[j] + a.activity_duration, -r));
+                }
+            }
+            // finishes sort before starts at the same time
+            sort(events.begin(), events.end());
+            int cur = 0, r_max = 0;
+            for(vector<pair<int, int> >::const_iterator it = events.begin(); it != events.end(); ++it) {
+                cur += it->second;
+                r_max = max(r_max, cur);
+            }
+            if(r_max > r_min)
+                metrics.resource_strength[k] = (file.resource_availability()[k] - r_min) / (double)(r_max - r_min);
+        }
+    });
+
+    long long rf = 0;
+    for(int k = 0; k < K; k++)rf += requested[k];
+    metrics.resource_factor = J > 0 && K > 0 ? rf / ((double)J * K) : 0.0;
+
+    metrics.ok = true;
+    return true;
+}
+
+/**
+ * @brief collects the instances to process for a path given via commandline
+ * @details a regular file is taken as is. Of a directory, all files with extension .rcp (not recursing into subdirectories) are added sorted by name.
+ *
+ * @param path file or directory
+ * @param files vector to append paths to
+ * @return false if path is neither a file nor a readable directory
+ */
+bool list_instances(const std::string& path, std::vector<std::string>& files) {
+    using namespace std;
+
+    vector<string> found;
+
+#if defined(WIN32) || defined(_WIN32)
+    DWORD attr = GetFileAttributesA(path.c_str());
+    if(attr == INVALID_FILE_ATTRIBUTES)return false;
+    if(!(attr & FILE_ATTRIBUTE_DIRECTORY)) {
+        files.push_back(path);
+        return true;
+    }
+
+    WIN32_FIND_DATAA data;
+    HANDLE h = FindFirstFileA((path + "\\*.rcp").c_str(), &data);
+    if(h != INVALID_HANDLE_VALUE) {
+        do {
+            if(!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))found.push_back(path + "\\" + data.cFileName);
+        } while(FindNextFileA(h, &data));
+        FindClose(h);
+    }
+#else
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)return false;
+    if(!S_ISDIR(st.st_mode)) {
+        files.push_back(path);
+        return true;
+    }
+
+    DIR *dir = opendir(path.c_str());
+    if(!dir)return false;
+    for(struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+        string name = entry->d_name;
+        if(name.size() < 4)continue;
+        string ext = name.substr(name.size() - 4);
+        transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if(ext != ".rcp")continue;
+        string full = path + "/" + name;
+        if(stat(full.c_str(), &st) == 0 && S_ISREG(st.st_mode))found.push_back(full);
+    }
+    closedir(dir);
+#endif
+
+    sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+    return true;
+}
+
+/**
+ * @brief computes metrics of many instances in parallel
+ * @details each worker thread parses and analyses one instance at a time, fetching the next one from a shared counter. A single instance is analysed using all threads instead. metrics[i] belongs to files[i], instances which could not be parsed have ok set to false.
+ *
+ * @param files paths of the instances
+ * @param threads number of threads to use
+ * @param metrics filled with one entry per file
+ * @return true if all instances could be analysed
+ */
+bool corpus_metrics(const std::vector<std::string>& files, const int threads, std::vector<InstanceMetrics>& metrics) {
+    using namespace std;
+
+    if(threads <= 0)return false;
+
+    metrics.assign(files.size(), InstanceMetrics());
+    for(unsigned int i = 0; i < files.size(); i++)metrics[i].instance = files[i];
+
+    const int count = (int)files.size();
+    const int num_threads = max(min(threads, count), 1);
+    const int inner_threads = count == 1 ? threads : 1;
+
+    atomic<int> next_file(0);
+    atomic<int> failures(0);
+
+    vector<thread> workers;
+    for(int t = 0; t < num_threads; t++) {
+        workers.push_back(thread([&]() {
+            for(int i = next_file++; i < count; i = next_file++) {
+                RanGenFile file(files[i]);
+                if(file.bad() || !compute_metrics(file, inner_threads, metrics[i]))failures++;
+            }
+        }));
+    }
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+
+    return failures == 0;
+}
@@ -0,0 +1,49 @@
+//
+//  Metrics.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Metrics_h
+#define RanGenConv_Metrics_h
+
+#include "RanGenFile.h"
+#include "OutputSink.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief network and resource characteristics of one instance
+ * @details dummy start/end nodes are excluded from all counts except arcs and the coefficient of network complexity, which follows ProGen and counts all arcs per node including the dummies.
+ */
+class InstanceMetrics {
+public:
+    std::string             instance;           /**< path of the instance */
+    bool                    ok;                 /**< false if the instance could not be parsed */
+    int                     activities;         /**< number of non-dummy activities J */
+    int                     resources;          /**< number of renewable resources K */
+    int                     arcs;               /**< number of arcs including those of the dummies */
+    double                  cnc;                /**< coefficient of network complexity, arcs per node */
+    double                  order_strength;     /**< precedence pairs of the transitive closure / (J (J - 1) / 2) */
+    double                  resource_factor;    /**< average fraction of resources requested per activity */
+    std::vector<double>     resource_strength;  /**< resource strength of each resource */
+    int                     levels;             /**< number of progressive levels */
+    int                     max_width;          /**< maximum number of activities on one level */
+    double                  serial_parallel;    /**< (levels - 1) / (J - 1), 1 for a chain, 0 for parallel activities */
+    int                     cpl;                /**< critical path length */
+
+    InstanceMetrics() : ok(false), activities(0), resources(0), arcs(0), cnc(0.0), order_strength(0.0), resource_factor(0.0), levels(0), max_width(0), serial_parallel(0.0), cpl(0) {}
+
+    double                  min_resource_strength() const;
+    double                  mean_resource_strength() const;
+
+    static void             print_csv_header(OutputSink& out);
+    void                    print_csv(OutputSink& out) const;
+    void                    print_json(OutputSink& out) const;
+};
+
+bool                        compute_metrics(RanGenFile& file, const int threads, InstanceMetrics& metrics);
+bool                        list_instances(const std::string& path, std::vector<std::string>& files);
+bool                        corpus_metrics(const std::vector<std::string>& files, const int threads, std::vector<InstanceMetrics>& metrics);
+
+#endif
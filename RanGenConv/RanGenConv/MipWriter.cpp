@@ -0,0 +1,326 @@
+//
+//  MipWriter.cpp
+//  RanGenConv
+//
+
+#include "MipWriter.h"
+
+#include <vector>
+#include <algorithm>
+
+// number of terms per line of the LP format, keeps lines well below the 510 characters some readers accept
+#define LP_TERMS_PER_LINE 8
+
+/**
+ * @brief time-indexed (pulse) formulation of an instance with generated windows
+ * @details binary x_j_s is 1 iff activity j starts at time s, s ranges over its start window [release_j, deadline_j - p_j] only. Rows are
+ *   a_j:     sum_s x_j_s = 1                                           (each activity starts once)
+ *   p_i_j:   sum_s s x_j_s - sum_s s x_i_s >= p_i                      (precedence relation <i, j>)
+ *   m_j:     Cmax - sum_s (s + p_j) x_j_s >= 0                         (activities without successors)
+ *   r_k_t:   sum_j r_jk sum_{s = t - p_j}^{t - 1} x_j_s <= R_k         (resource k in period t covering [t - 1, t))
+ * and Cmax is minimized. Resource rows are left out if the activities whose windows cover period t can not overload resource k. Only O(activities + horizon x resources) values are kept in memory, the rows (LP) and columns (MPS) are written as they are computed.
+ */
+class TimeIndexedModel {
+public:
+    RanGenFile&             file;
+    int                     offset;         /**< node of activity 1 */
+    int                     n;              /**< number of activities */
+    int                     K;              /**< number of resources */
+    int                     H;              /**< horizon */
+    std::vector<char>       sink;           /**< activity has no successor */
+    std::vector<long long>  load;           /**< sum of demands of activities whose window covers period t, (H + 2) entries per resource */
+
+    TimeIndexedModel(RanGenFile& file, const bool dummynodes);
+
+    const node&             activity(const int j) {return file.nodes(j + offset);}
+    int                     first_start(const int j) {return activity(j).release;}
+    int                     last_start(const int j) {return activity(j).deadline - activity(j).activity_duration;}
+    int                     demand(const int j, const int k) {
+        const std::vector<int>& req = activity(j).resource_requirements;
+        return k < (int)req.size() ? req[k] : 0;
+    }
+
+    /**
+     * @return true if node is left out, i.e. a dummy while dummies are not written
+     */
+    bool                    skipped(const int v) {return v < offset || v >= offset + n;}
+
+    /**
+     * @return true if row r_k_t is part of the model
+     */
+    bool                    resource_row(const int k, const int t) {return load[(size_t)k * (H + 2) + t] > file.resource_availability()[k];}
+
+    /**
+     * @return true if row p_i_j has at least one term with nonzero coefficient
+     */
+    bool                    precedence_row(const int i, const int j) {return last_start(i) > 0 || last_start(j) > 0;}
+};
+
+TimeIndexedModel::TimeIndexedModel(RanGenFile& file, const bool dummynodes):file(file) {
+    offset = dummynodes ? 0 : 1;
+    n = file.node_count() - 2 * offset;
+    K = file.resource_count();
+    H = file.horizon();
+
+    sink.assign(n, 1);
+    for(int j = 0; j < n; j++) {
+        const std::vector<int>& succ = file.successors(j + offset);
+        for(std::vector<int>::const_iterator it = succ.begin(); it != succ.end(); ++it)
+            if(!skipped(*it))sink[j] = 0;
+    }
+
+    // activity j occupies one period t in release_j + 1..deadline_j, difference array per resource
+    load.assign((size_t)K * (H + 2), 0);
+    for(int j = 0; j < n; j++) {
+        if(activity(j).activity_duration <= 0)continue;
+        for(int k = 0; k < K; k++) {
+            load[(size_t)k * (H + 2) + activity(j).release + 1] += demand(j, k);
+            load[(size_t)k * (H + 2) + activity(j).deadline + 1] -= demand(j, k);
+        }
+    }
+    for(int k = 0; k < K; k++)
+        for(int t = 1; t <= H + 1; t++)load[(size_t)k * (H + 2) + t] += load[(size_t)k * (H + 2) + t - 1];
+}
+
+/**
+ * @brief writes name of variable x_j_s, activities are numbered starting with 1
+ */
+static void variable(OutputSink& out, const int j, const int s) {
+    out<<"x"<<(j + 1)<<"_"<<s;
+}
+
+/**
+ * @brief writes one row or a list of variables of the LP format, breaking lines after LP_TERMS_PER_LINE terms
+ */
+class LpRow {
+    OutputSink&             _out;
+    int                     _terms;
+public:
+    LpRow(OutputSink& out):_out(out), _terms(0) {}
+
+    void                    separate() {
+        if(_terms > 0 && _terms % LP_TERMS_PER_LINE == 0)_out<<'\n'<<"   ";
+        _terms++;
+    }
+    void                    term(const long long coefficient, const int j, const int s) {
+        separate();
+        _out<<(coefficient < 0 ? " - " : " + ")<<(coefficient < 0 ? -coefficient : coefficient)<<" ";
+        variable(_out, j, s);
+    }
+    void                    term(const char *name) {
+        separate();
+        _out<<" + "<<name;
+    }
+    void                    name(const int j, const int s) {
+        separate();
+        _out<<" ";
+        variable(_out, j, s);
+    }
+    int                     terms() const {return _terms;}
+};
+
+/**
+ * @brief visits all resource rows, sweeping over the periods while keeping the activities whose window covers the period
+ */
+template<typename Visitor> static void sweep_resources(TimeIndexedModel& m, Visitor& visit) {
+    using namespace std;
+
+    vector<pair<int, int> > by_release; // (release, activity)
+    for(int j = 0; j < m.n; j++)
+        if(m.activity(j).activity_duration > 0)by_release.push_back(make_pair(m.activity(j).release, j));
+    sort(by_release.begin(), by_release.end());
+
+    vector<int> active;
+    size_t next = 0;
+    for(int t = 1; t <= m.H; t++) {
+        while(next < by_release.size() && by_release[next].first < t)active.push_back(by_release[next++].second);
+        size_t kept = 0;
+        for(size_t a = 0; a < active.size(); a++)
+            if(m.activity(active[a]).deadline >= t)active[kept++] = active[a];
+        active.resize(kept);
+
+        for(int k = 0; k < m.K; k++)
+            if(m.resource_row(k, t))visit(k, t, active);
+    }
+}
+
+/**
+ * @brief writes resource rows in LP format
+ */
+class LpResourceRows {
+    TimeIndexedModel&       _m;
+    OutputSink&             _out;
+public:
+    LpResourceRows(TimeIndexedModel& m, OutputSink& out):_m(m), _out(out) {}
+
+    void operator () (const int k, const int t, const std::vector<int>& active) {
+        _out<<" r"<<(k + 1)<<"_"<<t<<":";
+        LpRow row(_out);
+        for(std::vector<int>::const_iterator it = active.begin(); it != active.end(); ++it) {
+            const int j = *it, r = _m.demand(j, k);
+            if(r == 0)continue;
+            const int p = _m.activity(j).activity_duration;
+            for(int s = std::max(_m.first_start(j), t - p); s <= std::min(_m.last_start(j), t - 1); s++)row.term(r, j, s);
+        }
+        _out<<" <= "<<_m.file.resource_availability()[k]<<'\n';
+    }
+};
+
+/**
+ * @brief writes model in CPLEX LP format row by row
+ */
+static bool write_lp(TimeIndexedModel& m, OutputSink& out) {
+    using namespace std;
+
+    out<<"\\ time-indexed model, x_j_s = 1 iff activity j starts at s"<<'\n';
+    out<<"Minimize"<<'\n'<<" obj: Cmax"<<'\n'<<"Subject To"<<'\n';
+
+    for(int j = 0; j < m.n; j++) {
+        out<<" a"<<(j + 1)<<":";
+        LpRow row(out);
+        for(int s = m.first_start(j); s <= m.last_start(j); s++)row.term(1, j, s);
+        out<<" = 1"<<'\n';
+    }
+
+    for(RanGenFile::edge_iterator it = m.file.edges_begin(); it != m.file.edges_end(); ++it) {
+        if(m.skipped(it.source()) || m.skipped(it.target()))continue;
+        const int i = it.source() - m.offset, j = it.target() - m.offset;
+        if(!m.precedence_row(i, j))continue;
+        out<<" p"<<(i + 1)<<"_"<<(j + 1)<<":";
+        LpRow row(out);
+        for(int s = max(m.first_start(j), 1); s <= m.last_start(j); s++)row.term(s, j, s);
+        for(int s = max(m.first_start(i), 1); s <= m.last_start(i); s++)row.term(-s, i, s);
+        out<<" >= "<<m.activity(i).activity_duration<<'\n';
+    }
+
+    for(int j = 0; j < m.n; j++) {
+        if(!m.sink[j])continue;
+        out<<" m"<<(j + 1)<<":";
+        LpRow row(out);
+        row.term("Cmax");
+        const int p = m.activity(j).activity_duration;
+        for(int s = m.first_start(j); s <= m.last_start(j); s++)
+            if(s + p > 0)row.term(-(s + p), j, s);
+        out<<" >= 0"<<'\n';
+    }
+
+    LpResourceRows resources(m, out);
+    sweep_resources(m, resources);
+
+    out<<"Binaries"<<'\n';
+    for(int j = 0; j < m.n; j++) {
+        LpRow row(out);
+        for(int s = m.first_start(j); s <= m.last_start(j); s++)row.name(j, s);
+        out<<'\n';
+    }
+    out<<"End"<<'\n';
+
+    return out.good();
+}
+
+/**
+ * @brief lists resource rows in the ROWS section of the MPS format
+ */
+class MpsResourceRows {
+    OutputSink&             _out;
+public:
+    MpsResourceRows(OutputSink& out):_out(out) {}
+
+    void operator () (const int k, const int t, const std::vector<int>& /*active*/) {
+        _out<<" L  r"<<(k + 1)<<"_"<<t<<'\n';
+    }
+};
+
+/**
+ * @brief writes one entry of the COLUMNS section
+ */
+static void column_entry(OutputSink& out, const int j, const int s, const char *row, const int a, const int b, const long long value) {
+    out<<"    ";
+    variable(out, j, s);
+    out<<"  "<<row<<a;
+    if(b >= 0)out<<"_"<<b;
+    out<<"  "<<value<<'\n';
+}
+
+/**
+ * @brief writes model in free MPS format, the matrix column by column
+ */
+static bool write_mps(TimeIndexedModel& m, OutputSink& out) {
+    using namespace std;
+
+    out<<"NAME          RANGENCONV"<<'\n'<<"ROWS"<<'\n'<<" N  obj"<<'\n';
+    for(int j = 0; j < m.n; j++)out<<" E  a"<<(j + 1)<<'\n';
+    for(RanGenFile::edge_iterator it = m.file.edges_begin(); it != m.file.edges_end(); ++it) {
+        if(m.skipped(it.source()) || m.skipped(it.target()))continue;
+        const int i = it.source() - m.offset, j = it.target() - m.offset;
+        if(m.precedence_row(i, j))out<<" G  p"<<(i + 1)<<"_"<<(j + 1)<<'\n';
+    }
+    for(int j = 0; j < m.n; j++)
+        if(m.sink[j])out<<" G  m"<<(j + 1)<<'\n';
+    MpsResourceRows resources(out);
+    sweep_resources(m, resources);
+
+    out<<"COLUMNS"<<'\n';
+    for(int j = 0; j < m.n; j++) {
+        const int p = m.activity(j).activity_duration;
+        const vector<int>& pred = m.file.predecessors(j + m.offset);
+        const vector<int>& succ = m.file.successors(j + m.offset);
+        for(int s = m.first_start(j); s <= m.last_start(j); s++) {
+            column_entry(out, j, s, "a", j + 1, -1, 1);
+            for(vector<int>::const_iterator it = pred.begin(); it != pred.end(); ++it) {
+                const int i = *it - m.offset;
+                if(!m.skipped(*it) && s > 0 && m.precedence_row(i, j))column_entry(out, j, s, "p", i + 1, j + 1, s);
+            }
+            for(vector<int>::const_iterator it = succ.begin(); it != succ.end(); ++it) {
+                const int k = *it - m.offset;
+                if(!m.skipped(*it) && s > 0 && m.precedence_row(j, k))column_entry(out, j, s, "p", j + 1, k + 1, -s);
+            }
+            if(m.sink[j] && s + p > 0)column_entry(out, j, s, "m", j + 1, -1, -(s + p));
+            for(int t = s + 1; t <= s + p; t++)
+                for(int k = 0; k < m.K; k++)
+                    if(m.demand(j, k) != 0 && m.resource_row(k, t))column_entry(out, j, s, "r", k + 1, t, m.demand(j, k));
+        }
+    }
+    out<<"    Cmax  obj  1"<<'\n';
+    for(int j = 0; j < m.n; j++)
+        if(m.sink[j])out<<"    Cmax  m"<<(j + 1)<<"  1"<<'\n';
+
+    out<<"RHS"<<'\n';
+    for(int j = 0; j < m.n; j++)out<<"    rhs  a"<<(j + 1)<<"  1"<<'\n';
+    for(RanGenFile::edge_iterator it = m.file.edges_begin(); it != m.file.edges_end(); ++it) {
+        if(m.skipped(it.source()) || m.skipped(it.target()))continue;
+        const int i = it.source() - m.offset, j = it.target() - m.offset;
+        if(m.precedence_row(i, j) && m.activity(i).activity_duration != 0)
+            out<<"    rhs  p"<<(i + 1)<<"_"<<(j + 1)<<"  "<<m.activity(i).activity_duration<<'\n';
+    }
+    for(int k = 0; k < m.K; k++)
+        for(int t = 1; t <= m.H; t++)
+            if(m.resource_row(k, t))out<<"    rhs  r"<<(k + 1)<<"_"<<t<<"  "<<m.file.resource_availability()[k]<<'\n';
+
+    out<<"BOUNDS"<<'\n';
+    for(int j = 0; j < m.n; j++)
+        for(int s = m.first_start(j); s <= m.last_start(j); s++) {
+            out<<" BV bnd  ";
+            variable(out, j, s);
+            out<<'\n';
+        }
+    out<<"ENDATA"<<'\n';
+
+    return out.good();
+}
+
+/**
+ * @brief writes time-indexed MIP model of an instance with generated windows, see TimeIndexedModel
+ * @details the model is streamed: LP row by row, MPS column by column, without building the constraint matrix.
+ *
+ * @param file instance with generated and validated windows
+ * @param out sink to write to
+ * @param dummynodes set to true to include dummy start and end as activities
+ * @param format LP or MPS
+ * @return true if no errors occured
+ */
+bool write_mip(RanGenFile& file, OutputSink& out, const bool dummynodes, const MipFormat format) {
+    TimeIndexedModel m(file, dummynodes);
+    if(m.n <= 0)return false;
+    return format == MIP_MPS ? write_mps(m, out) : write_lp(m, out);
+}
@@ -0,0 +1,22 @@
+//
+//  MipWriter.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_MipWriter_h
+#define RanGenConv_MipWriter_h
+
+#include "RanGenFile.h"
+#include "OutputSink.h"
+
+/**
+ * @brief file formats of the time-indexed model
+ */
+enum MipFormat {
+    MIP_LP = 0,                         /**< CPLEX LP format */
+    MIP_MPS                             /**< free MPS format */
+};
+
+bool                        write_mip(RanGenFile& file, OutputSink& out, const bool dummynodes, const MipFormat format);
+
+#endif
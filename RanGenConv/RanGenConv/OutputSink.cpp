@@ -0,0 +1,229 @@
+//
+//  OutputSink.cpp
+//  RanGenConv
+//
+
+#include "OutputSink.h"
+
+#include <cmath>
+#include <cfloat>
+
+// number of buffers a sink writes behind at most
+#define OUTPUT_WRITES_IN_FLIGHT 2
+
+/**
+ * @brief creates a sink which is not attached to a file yet, use open
+ *
+ * @param capacity size of the buffer in bytes
+ */
+OutputSink::OutputSink(const size_t capacity):_file(NULL), _own(false), _good(true), _memory(false), _compressor(NULL), _append(false), _io(NULL), _fd(-1), _buffer(capacity > 64 ? capacity : 64), _used(0), _drained(0) {
+
+}
+
+/**
+ * @brief creates a sink writing to an already opened file, which is not closed by the sink
+ *
+ * @param file file to write to
+ * @param capacity size of the buffer in bytes
+ */
+OutputSink::OutputSink(FILE *file, const size_t capacity):_file(file), _own(false), _good(file != NULL), _memory(false), _compressor(NULL), _append(false), _io(NULL), _fd(-1), _buffer(capacity > 64 ? capacity : 64), _used(0), _drained(0) {
+
+}
+
+OutputSink::~OutputSink() {
+    close();
+}
+
+/**
+ * @brief opens file for writing, a previously opened file is closed first
+ * @details compressed output is produced by a compressor thread fed with the full buffers of the sink. Appending to a compressed file adds another gzip member / zstd frame, which decompresses to the concatenation of both.
+ *
+ * @param filename path of file to write to
+ * @param binary set to true to suppress newline translation (Windows)
+ * @param append set to true to append to an existing file instead of truncating it
+ * @param compression compression method, which has to be available (see compression_available)
+ * @return true if file could be opened
+ */
+bool OutputSink::open(const char *filename, const bool binary, const bool append, const CompressionMethod compression) {
+    close();
+
+    // compressed data is binary regardless of its contents
+    const bool raw = binary || compression != COMPRESSION_NONE;
+    const char *mode = append ? (raw ? "ab" : "a") : (raw ? "wb" : "w");
+    _file = fopen(filename, mode);
+    _own = true;
+    _memory = false;
+    _append = append;
+    _good = _file != NULL;
+    _drained = 0;
+
+    // buffering is done by the sink
+    if(_file)setvbuf(_file, NULL, _IONBF, 0);
+
+    if(_good && compression != COMPRESSION_NONE) {
+        _compressor = new Compressor();
+        _good = _compressor->start(_file, compression);
+    }
+
+    return _good;
+}
+
+/**
+ * @brief keeps all bytes written in memory instead of writing them to a file, see data and size
+ * @details used to format parts of a file concurrently, a previously opened file is closed first
+ */
+void OutputSink::open_memory() {
+    close();
+
+    _memory = true;
+    _good = true;
+    _used = 0;
+    _drained = 0;
+}
+
+/**
+ * @brief hands full buffers to an I/O thread instead of writing them on the calling thread
+ * @details the sink continues formatting into a fresh buffer while the previous ones are written, at most OUTPUT_WRITES_IN_FLIGHT buffers are written at once. Compressed output is left to its compressor thread, which overlaps writing already.
+ *
+ * @param io I/O thread, has to outlive the file
+ * @return false if the sink is not attached to a plain file opened for writing from the start
+ */
+bool OutputSink::write_behind(AsyncIO *io) {
+    if(!_file || _memory || _compressor || _append || !io)return false;
+
+    drain();
+#if defined(WIN32) || defined(_WIN32)
+    _fd = _fileno(_file);
+#else
+    _fd = fileno(_file);
+#endif
+    _io = io;
+    return _fd >= 0;
+}
+
+/**
+ * @brief waits until all writes handed to the I/O thread are finished
+ * @return true if no errors occured so far
+ */
+bool OutputSink::wait_writes() {
+    while(!_writes.empty()) {
+        if(!_io->wait(*_writes.front()))_good = false;
+        delete _writes.front();
+        _writes.pop_front();
+    }
+    return _good;
+}
+
+/**
+ * @brief hands the buffered bytes to the file
+ * @return true if no errors occured so far
+ */
+bool OutputSink::drain() {
+    if(_memory)return _good;
+    if(_compressor) {
+        _compressor->push(_buffer, _used);
+        _drained += _used;
+        _used = 0;
+        return good();
+    }
+    if(_io) {
+        if(_used == 0)return _good;
+        // reuse the buffer of the oldest write once the limit is reached
+        AsyncIORequest *r;
+        if(_writes.size() >= OUTPUT_WRITES_IN_FLIGHT) {
+            r = _writes.front();
+            _writes.pop_front();
+            if(!_io->wait(*r))_good = false;
+        }
+        else r = new AsyncIORequest();
+        const size_t capacity = _buffer.size();
+        r->buffer.swap(_buffer);
+        if(_buffer.size() < capacity)_buffer.resize(capacity);
+        r->fd = _fd;
+        r->write = true;
+        r->data = &r->buffer[0];
+        r->length = _used;
+        r->offset = _drained;
+        _io->submit(*r);
+        _writes.push_back(r);
+        _drained += _used;
+        _used = 0;
+        return _good;
+    }
+    if(_used > 0) {
+        if(!_file || fwrite(&_buffer[0], 1, _used, _file) != _used)_good = false;
+        _drained += _used;
+        _used = 0;
+    }
+    return _good;
+}
+
+/**
+ * @brief writes all buffered bytes to the file
+ * @return true if no errors occured so far
+ */
+bool OutputSink::flush() {
+    drain();
+    if(_io)wait_writes();
+    // the file is written by the compressor thread until close
+    if(_file && !_compressor && fflush(_file) != 0)_good = false;
+    return good();
+}
+
+/**
+ * @brief flushes the buffer and closes the file if it was opened by open
+ * @return true if all data was written successfully
+ */
+bool OutputSink::close() {
+    if(!_file)return _good;
+
+    bool res = flush();
+    if(_compressor) {
+        if(!_compressor->finish())res = false;
+        delete _compressor;
+        _compressor = NULL;
+        if(fflush(_file) != 0)res = false;
+    }
+    if(_own && fclose(_file) != 0)res = false;
+    _file = NULL;
+    _own = false;
+    _io = NULL;
+    _fd = -1;
+
+    return res;
+}
+
+/**
+ * @brief writes value in the shortest representation which parses back to the same double
+ * @details without to_chars, 15 and 16 significant digits are tried before falling back to 17, which always suffice. Any decimal of up to 15 digits survives a round trip through a normal double and %g drops trailing zeros, hence the first precision parsing back to value yields the shortest digits. Subnormal numbers have fewer digits of precision and are tried starting with a single digit.
+ */
+OutputSink& OutputSink::write_double(const double value) {
+    char *p = reserve(32);
+#if defined(RANGENCONV_HAVE_TO_CHARS) && defined(__cpp_lib_to_chars)
+    _used = std::to_chars(p, p + 32, value).ptr - &_buffer[0];
+#else
+    int n = 0;
+    for(int precision = fabs(value) < DBL_MIN ? 1 : 15; precision <= 17; precision++) {
+        n = snprintf(p, 32, "%.*g", precision, value);
+        if(precision == 17 || strtod(p, NULL) == value)break;
+    }
+    _used += n;
+#endif
+    return *this;
+}
+
+/**
+ * @brief writes value with precision significant digits, same as printf's %g or iostreams with default flags
+ *
+ * @param value value to write
+ * @param precision number of significant digits (1 - 17)
+ */
+OutputSink& OutputSink::write_double(const double value, const int precision) {
+    char *p = reserve(32);
+#if defined(RANGENCONV_HAVE_TO_CHARS) && defined(__cpp_lib_to_chars)
+    _used = std::to_chars(p, p + 32, value, std::chars_format::general, precision).ptr - &_buffer[0];
+#else
+    _used += snprintf(p, 32, "%.*g", precision, value);
+#endif
+    return *this;
+}
@@ -0,0 +1,187 @@
+//
+//  OutputSink.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_OutputSink_h
+#define RanGenConv_OutputSink_h
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "helper.h"
+#include "Compression.h"
+#include "AsyncIO.h"
+
+// std::to_chars requires C++17, older compilers fall back to hand written integer and printf double formatting
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#define RANGENCONV_HAVE_TO_CHARS
+#endif
+
+/**
+ * @brief buffered writer used for all output files
+ * @details collects output in a large user-space buffer which is handed to the underlying FILE in one call whenever it is full and when flush or close are called, i.e. writing is never flushed per line. The FILE itself is unbuffered to avoid copying data twice. Numbers are formatted via std::to_chars if available, which in contrast to iostreams does not depend on the locale. Errors are sticky and reported via good, flush and close.
+ */
+class OutputSink {
+private:
+    FILE                   *_file;
+    bool                    _own;               /**< true if _file was opened by open and has to be closed */
+    bool                    _good;
+    bool                    _memory;            /**< bytes are kept in the buffer instead of being written to a file */
+    Compressor             *_compressor;        /**< compresses the buffer before it is written, NULL for plain files */
+    bool                    _append;            /**< file was opened for appending */
+    AsyncIO                *_io;                /**< writes full buffers behind, NULL to write them directly */
+    int                     _fd;                /**< descriptor of _file if _io is set */
+    std::deque<AsyncIORequest *> _writes;       /**< writes in flight, oldest first */
+    std::vector<char>       _buffer;
+    size_t                  _used;              /**< number of bytes of _buffer in use */
+    unsigned long long      _drained;           /**< number of bytes handed to _file so far */
+
+    bool                    drain();
+    bool                    wait_writes();
+
+    // not copyable
+    OutputSink(const OutputSink& other);
+    OutputSink& operator = (const OutputSink& other);
+
+    /**
+     * @brief makes sure n more bytes fit into the buffer
+     */
+    char                   *reserve(const size_t n) {
+        if(_used + n > _buffer.size()) {
+            if(_memory)_buffer.resize(std::max(2 * _buffer.size(), _used + n));
+            else drain();
+        }
+        return &_buffer[_used];
+    }
+
+    template<typename T> OutputSink& write_integer(T value) {
+        char *p = reserve(24);
+#ifdef RANGENCONV_HAVE_TO_CHARS
+        _used = std::to_chars(p, p + 24, value).ptr - &_buffer[0];
+#else
+        char digits[24];
+        int n = 0;
+        bool negative = value < 0;
+        do {
+            int d = (int)(value % 10);
+            digits[n++] = (char)('0' + (d < 0 ? -d : d));
+            value /= 10;
+        } while(value != 0);
+        if(negative)*p++ = '-';
+        while(n > 0)*p++ = digits[--n];
+        _used = p - &_buffer[0];
+#endif
+        return *this;
+    }
+
+public:
+    static const size_t     default_capacity = 1 << 20;
+
+    OutputSink(const size_t capacity = default_capacity);
+    OutputSink(FILE *file, const size_t capacity = default_capacity);
+    ~OutputSink();
+
+    bool                    open(const char *filename, const bool binary = false, const bool append = false, const CompressionMethod compression = COMPRESSION_NONE);
+    void                    open_memory();
+    bool                    write_behind(AsyncIO *io);
+    bool                    flush();
+    bool                    close();
+    bool                    good() const {return _good && (_file || _memory) && (!_compressor || _compressor->good());}
+    
+    /**
+     * @return number of bytes written to the sink since it was created or opened, before compression
+     */
+    unsigned long long      tell() const {return _drained + _used;}
+
+    /**
+     * @brief bytes of a sink opened via open_memory
+     */
+    const char             *data() const {return &_buffer[0];}
+    size_t                  size() const {return _used;}
+    void                    clear() {_used = 0;}
+
+    OutputSink&             put(const char c) {
+        *reserve(1) = c;
+        _used++;
+        return *this;
+    }
+
+    OutputSink&             write(const char *data, const size_t n) {
+        if(n >= _buffer.size() && (_compressor || _io)) {
+            // compressed and written behind data passes the buffer in pieces
+            for(size_t done = 0; done < n;) {
+                const size_t piece = std::min(n - done, _buffer.size() - _used);
+                memcpy(&_buffer[_used], data + done, piece);
+                _used += piece;
+                done += piece;
+                if(_used == _buffer.size())drain();
+            }
+            return *this;
+        }
+        if(n >= _buffer.size() && !_memory) {
+            // large chunks bypass the buffer
+            drain();
+            if(_file && fwrite(data, 1, n, _file) != n)_good = false;
+            _drained += n;
+            return *this;
+        }
+        memcpy(reserve(n), data, n);
+        _used += n;
+        return *this;
+    }
+
+    OutputSink&             write_double(const double value);
+    OutputSink&             write_double(const double value, const int precision);
+
+    OutputSink&             operator << (const char *s) {return write(s, strlen(s));}
+    OutputSink&             operator << (const std::string& s) {return write(s.data(), s.size());}
+    OutputSink&             operator << (const char c) {return put(c);}
+    OutputSink&             operator << (const int value) {return write_integer(value);}
+    OutputSink&             operator << (const unsigned int value) {return write_integer(value);}
+    OutputSink&             operator << (const long value) {return write_integer(value);}
+    OutputSink&             operator << (const unsigned long value) {return write_integer(value);}
+    OutputSink&             operator << (const long long value) {return write_integer(value);}
+    OutputSink&             operator << (const unsigned long long value) {return write_integer(value);}
+    OutputSink&             operator << (const double value) {return write_double(value);}
+};
+
+/**
+ * @brief formats count elements in chunks on up to threads threads, handing the chunks in order to write
+ * @details format(begin, end, buffer) writes elements [begin, end) to buffer, a sink kept in memory, write(begin, end, buffer) consumes the result. Chunks of chunk elements are formatted in rounds of threads chunks, hence memory is bounded by the output of threads chunks. As chunks are consumed in order, the output is the same as formatting all elements on one thread.
+ *
+ * @param count number of elements
+ * @param threads number of threads to use
+ * @param chunk number of elements per chunk
+ * @param format formats a range of elements, called concurrently
+ * @param write consumes a formatted chunk, called on the calling thread
+ */
+template<typename F, typename W> void format_chunked(const long long count, const int threads, const long long chunk, F format, W write) {
+    using namespace std;
+
+    vector<OutputSink *> buffers(max(threads, 1));
+    for(size_t i = 0; i < buffers.size(); i++) {
+        buffers[i] = new OutputSink(1 << 16);
+        buffers[i]->open_memory();
+    }
+
+    const long long round_size = chunk * (long long)buffers.size();
+    for(long long round = 0; round < count; round += round_size) {
+        const int chunks = (int)min((long long)buffers.size(), (count - round + chunk - 1) / chunk);
+        parallel_for(chunks, chunks, 1, [&](int b, int e) {
+            for(int c = b; c < e; c++) {
+                buffers[c]->clear();
+                format(round + c * chunk, min(count, round + (c + 1) * chunk), *buffers[c]);
+            }
+        });
+        for(int c = 0; c < chunks; c++)write(round + c * chunk, min(count, round + (c + 1) * chunk), *buffers[c]);
+    }
+
+    for(size_t i = 0; i < buffers.size(); i++)delete buffers[i];
+}
+
+#endif
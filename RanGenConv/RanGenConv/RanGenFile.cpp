@@ -8,11 +8,24 @@
 
 #include "RanGenFile.h"
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <queue>
 
-RanGenFile::RanGenFile(std::string filename) {
+RanGenFile::RanGenFile(std::string filename):_horizon_factor(0.0) {
     _bad = !parse_file(filename); // invert as parse_file returns true for success!
 }
 
+/**
+ * @brief parses an instance which was read into memory before, e.g. by a prefetching stage
+ *
+ * @param is stream holding the instance in Patterson format
+ * @param name name of the instance used in messages
+ */
+RanGenFile::RanGenFile(std::istream& is, const std::string& name):_horizon_factor(0.0) {
+    _bad = !parse(is, name);
+}
+
 RanGenFile::~RanGenFile() {
     
 }
@@ -28,23 +41,36 @@ RanGenFile::~RanGenFile() {
 bool RanGenFile::parse_file(std::string filename) {
     using namespace std;
     
+    ifstream ifs;
+    ifs.open(filename);
+    
+    if(ifs.fail() || ifs.bad()) {
+        cout<<"error: "<<"file could not been opened successfully"<<endl;
+        return false;
+    }
+    return parse(ifs, filename);
+}
+
+/**
+ * @brief parses an instance in Patterson format from a stream
+ * 
+ * @param ifs stream to read from
+ * @param filename name of the instance used in messages
+ * @return true if no errors occured
+ */
+bool RanGenFile::parse(std::istream& ifs, const std::string& filename) {
+    using namespace std;
+    
     bool res = true;
     node dline;
     unsigned int num_nodes = 0;
     num_resources = 0;
     vector<node> nodes;
     
-    ifstream ifs;
-    
     int line_number = 0;
-    ifs.open(filename);
     
     int id = 1; // give lines ids
     
-    if(ifs.fail() || ifs.bad()) {
-        cout<<"error: "<<"file could not been opened successfully"<<endl;
-        return false;
-    }
     for (string line; getline(ifs, line); )
     {
         // go over empty lines
@@ -101,15 +127,26 @@ bool RanGenFile::parse_file(std::string filename) {
     }
     
     
+    // a truncated file or an invalid successor would corrupt the graph
+    if(nodes.empty() || nodes.size() != num_nodes) {
+        cout<<"error: "<<filename<<" declares "<<num_nodes<<" activities, but lists "<<nodes.size()<<endl;
+        return false;
+    }
+    for(vector<node>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+        for(vector<int>::const_iterator jt = it->children.begin(); jt != it->children.end(); ++jt)
+            if(*jt < 1 || *jt > (int)num_nodes) {
+                cout<<"error: activity "<<it->id<<" of "<<filename<<" has invalid successor "<<*jt<<endl;
+                return false;
+            }
+    
     // assign all relations
-    if(!(res = build_adjmatrix(nodes)))cout<<"error while building adjacency matrix for graph"<<endl;
+    if(!(res = build_graph(nodes)))cout<<"error while building graph"<<endl;
     
     // now check if graph is really a DAG!
     if (G.isCyclic()) {
-        cout << "we have a huge problem! The graph is not a DAG!!!" << endl;
-        exit(1);
+        cout << "error: precedence graph of " << filename << " is not a DAG" << endl;
+        return false;
     }
-    else cout << "graph is a DAG, all fine" << endl;
     
     // now copy data contens to graph
     assert(!nodes.empty());
@@ -122,8 +159,8 @@ bool RanGenFile::parse_file(std::string filename) {
     return true;
 }
 
-// build adjacency matrix
-bool RanGenFile::build_adjmatrix(const std::vector<node>& V) {
+// build successor and predecessor lists
+bool RanGenFile::build_graph(const std::vector<node>& V) {
     
     bool res = true;
     
@@ -146,14 +183,34 @@ bool RanGenFile::build_adjmatrix(const std::vector<node>& V) {
        
 /**
  * @brief generates release and deadlines
- * @details generates release and deadlines w.r.t. to constraints.
+ * @details generates release and deadlines w.r.t. to constraints. Draws random numbers from a generator seeded via rand(), i.e. srand controls the result.
  * 
  * @param limit time limit used for generation of release/deadlines. Higher time_limit will cause a higher time horizon due to deadlines and release times more away from each other.
  * @return true if no errors occured
  */
 bool RanGenFile::generate_times(const int limit = 10) {
+    Random rnd(rand());
+    return generate_times(limit, rnd);
+}
+
+/**
+ * @brief generates release and deadlines
+ * @details generates release and deadlines w.r.t. to constraints. All random draws are taken from rnd, so that several copies of a RanGenFile can generate times concurrently.
+ * 
+ * @param limit time limit used for generation of release/deadlines. Higher time_limit will cause a higher time horizon due to deadlines and release times more away from each other.
+ * @param rnd random number generator to draw W, Z from
+ * @param horizon_factor if >= 1, use generate_bounded_times to keep the horizon within horizon_factor x critical path length
+ * @return true if no errors occured
+ */
+bool RanGenFile::generate_times(const int limit, Random& rnd, const double horizon_factor) {
    
     using namespace std;
+    
+    if (horizon_factor >= 1.0)
+        return generate_bounded_times(limit, horizon_factor, rnd);
+    
+    _horizon_factor = 0.0;
+
     stack<int> Stack;
     
     // perform firsthand topological sort
@@ -163,151 +220,489 @@ bool RanGenFile::generate_times(const int limit = 10) {
        int j = Stack.top();
        Stack.pop();
        
-       // for the generation three constraints have to be fulfilled
-       
-       // Let I be the set of all predecessor of node j
-       // i.e. precedences <i,j> hold for all i € I
-       
-       // d_x ... deadline of node x
-       // r_x ... release time of node x
-       // p_x ... duration of node x
-       
-       //  (1) d_i - r_i >= p_i    forall i € I
-       //      d_j - r_j >= p_j
-       //  (2) r_j - r_i >= p_i    forall i € I
-       //  (3) d_j - d_i >= p_j    forall i € I
-       
-       // algorithm:
-       // step1:   d_max = max d_i over I
-       //          r_max = max r_i over I
-       //          p_max = max p_i over I
-       // step2:   W ~ Geo(l1) Z ~ Geo(l2) or other discrete distribution, but W, Z >= 0 must hold true
-       //          X := p_max + W
-       //          Y := X + Z
-       // step3:
-       //          r_j := r_max + X
-       //          d_j := p_j + d_max + Y
-       
-       int d_max = 0; // -inf
-       int r_max = 0;
-       int p_max = 0;
-       
-       // go through all parents
-       for (int i = 0; i < node_count(); ++i) {
-           // check if set
-           if (G.get(i, j)) {
-               // i is parent of j!
-               node & parent = G.v(i);
-               
-               d_max = max(d_max, parent.deadline);
-               r_max = max(r_max, parent.release);
-               p_max = max(p_max, parent.activity_duration);
-           }
-       }
-       
-       static double l1 = 0.6;
-       static double l2 = 0.4;
-       
-       int W = georv(l1);
-       int Z = georv(l2);
-       
-       // only allowed values, limit W, Z to avoid exploding the time horizon
-       W = min(W, limit - rand() % (limit / 2)); // add some dynamic to limiting!
-       Z = min(Z, limit - rand() % (limit / 2));
+       int W, Z;
+       draw_padding(limit, rnd, W, Z);
        
        // special case, first dummy node will have everything set to zero!!!
        if (j == 0) {
            W = Z = 0;
        }
        
-       if (d_max < r_max) {
-           cout << "error: logical flaw found!!! d_max < r_max" << endl;
-       }
-       
-       // check if node has dummy start as parent, if so, inc W by 1 to make sure, all nodes start with time 1!
-       if(G.get(0, j))W += 1;
-       
-       int X = p_max + W;
-       int Y = X + Z;
-       
-       
-       G.v(j).release = r_max + X;
-       G.v(j).deadline = G.v(j).activity_duration + d_max + Y;
-       
+       G.v(j).pad_release = W;
+       G.v(j).pad_deadline = Z;
        
-       if (Y < X) {
-           cout << "something is wrong here" << endl;
-       }
-
-       assert(p_max >= 0);
-       assert(r_max >= 0);
-       assert(d_max >= 0);
-       assert(X >= p_max);
-       assert(Y >= X);
-       assert(G.v(j).deadline - G.v(j).release >= G.v(j).activity_duration);
-
+       compute_times(j);
    }
    
     return true;
 }
 
 /**
- * @brief validates generated times by checking constraints.
- * @details validates generated times using a topological sort w.r.t. given constraints. Outputs furhtmerore each occurence
- * @return true if genereated times do not violate constraints
+ * @brief generates release and deadlines keeping the horizon within a factor of the critical path length
+ * @details horizon-minimising variant of generate_times. Padding is only added where constraints (1) - (3) require it, i.e.
+ *          r_j := max(r_i + p_i) + W
+ *          d_j := max(r_j + p_j, d_max + p_j) + Z
+ * with W, Z drawn as in generate_times but W + Z <= (horizon_factor - 1) x p_j. For W = Z = 0 the windows collapse to the earliest start/finish of a critical path analysis, and as padding along any path sums up to at most (horizon_factor - 1) x its length, the horizon never exceeds horizon_factor x critical path length. Critical chains, i.e. long paths, are hence granted little slack per activity.
+ * 
+ * @param limit time limit used to limit W, Z as in generate_times
+ * @param horizon_factor maximum ratio of horizon and critical path length, has to be >= 1
+ * @param rnd random number generator to draw W, Z from
+ * @return true if no errors occured
  */
-bool RanGenFile::validate_times() {
+bool RanGenFile::generate_bounded_times(const int limit, const double horizon_factor, Random& rnd) {
     using namespace std;
     
-    bool res = true;
+    assert(horizon_factor >= 1.0);
+    _horizon_factor = horizon_factor;
     
-    for(int j = 0; j < node_count(); j++) {
-        node& root = G.v(j);
+    vector<int> order;
+    G.topologicalOrder(order);
+    
+    for (vector<int>::const_iterator it = order.begin(); it != order.end(); ++it) {
+        const int j = *it;
+        
+        int W, Z;
+        draw_padding(limit, rnd, W, Z);
         
-        double rmaxprogress = 1.0 / root.activity_duration + 0.000001;
-        int rduration = 1.0 / rmaxprogress;
+        // special case, first dummy node will have everything set to zero!!!
+        if (j == 0) {
+            W = Z = 0;
+        }
         
+        // budget (horizon_factor - 1) x p_j is applied in compute_times
+        G.v(j).pad_release = W;
+        G.v(j).pad_deadline = Z;
         
-        if (root.deadline - root.release < root.activity_duration) {
-            cout << "violation found: d_" << root.id << " - r_" << root.id << " < p_" << root.id << endl;
+        compute_times(j);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief draws the random padding W, Z of one node
+ * @details W ~ Geo(l1), Z ~ Geo(l2), both limited by a value drawn from (limit / 2, limit] to avoid exploding the time horizon.
+ * 
+ * @param limit time limit, has to be at least 2
+ * @param rnd random number generator to draw from
+ * @param W padding of release
+ * @param Z additional padding of deadline
+ */
+void RanGenFile::draw_padding(const int limit, Random& rnd, int& W, int& Z) {
+    using namespace std;
+    
+    static double l1 = 0.6;
+    static double l2 = 0.4;
+    
+    W = rnd.geometric(l1);
+    Z = rnd.geometric(l2);
+    
+    // only allowed values, limit W, Z to avoid exploding the time horizon
+    W = min(W, limit - rnd.next(limit / 2)); // add some dynamic to limiting!
+    Z = min(Z, limit - rnd.next(limit / 2));
+}
+
+/**
+ * @brief computes release and deadline of a node from the aggregate of its predecessors and its padding
+ * @details uses the formulas of generate_times or, if horizon_factor >= 1, of generate_bounded_times. Shared by compute_times and the streaming converter.
+ * 
+ * @param agg aggregate over all predecessors of the node
+ * @param duration duration p_j of the node
+ * @param W padding of release
+ * @param Z additional padding of deadline
+ * @param horizon_factor horizon factor, 0 for default mode
+ * @param release computed release r_j
+ * @param deadline computed deadline d_j
+ */
+void RanGenFile::window(const PredecessorAggregate& agg, const int duration, int W, int Z, const double horizon_factor, int& release, int& deadline) {
+    using namespace std;
+    
+    // for the generation three constraints have to be fulfilled
+    
+    // Let I be the set of all predecessor of node j
+    // i.e. precedences <i,j> hold for all i € I
+    
+    // d_x ... deadline of node x
+    // r_x ... release time of node x
+    // p_x ... duration of node x
+    
+    //  (1) d_i - r_i >= p_i    forall i € I
+    //      d_j - r_j >= p_j
+    //  (2) r_j - r_i >= p_i    forall i € I
+    //  (3) d_j - d_i >= p_j    forall i € I
+    
+    // algorithm:
+    // step1:   d_max = max d_i over I
+    //          r_max = max r_i over I
+    //          p_max = max p_i over I
+    // step2:   W ~ Geo(l1) Z ~ Geo(l2) or other discrete distribution, but W, Z >= 0 must hold true
+    //          X := p_max + W
+    //          Y := X + Z
+    // step3:
+    //          r_j := r_max + X
+    //          d_j := p_j + d_max + Y
+    
+    if (horizon_factor >= 1.0) {
+        int budget = (int)floor((horizon_factor - 1.0) * duration);
+        W = min(W, budget);
+        Z = min(Z, budget - W);
+        
+        // as in generate_times all nodes start with time 1
+        int shift = agg.dummy_parent ? 1 : 0;
+        
+        release = max(agg.ef_max, shift) + W;
+        deadline = max(release + duration, agg.d_max + duration) + Z;
+        
+        assert(W >= 0 && Z >= 0);
+    }
+    else {
+        if (agg.d_max < agg.r_max) {
+            cout << "error: logical flaw found!!! d_max < r_max" << endl;
         }
         
-        if (root.deadline - root.release < rduration) {
-            cout << "rounding violation found: d_" << root.id << " - r_" << root.id << " < p_" << root.id << endl;
+        // check if node has dummy start as parent, if so, inc W by 1 to make sure, all nodes start with time 1!
+        if(agg.dummy_parent)W += 1;
+        
+        int X = agg.p_max + W;
+        int Y = X + Z;
+        
+        release = agg.r_max + X;
+        deadline = duration + agg.d_max + Y;
+        
+        if (Y < X) {
+            cout << "something is wrong here" << endl;
         }
         
-        // go through parents
-        for (int i = 0; i < node_count(); ++i) {
-            
-            if (G.get(i, j)) {
-                node & parent = G.v(i);
-                if (!(parent.deadline - parent.release >= parent.activity_duration  // d_i - r_i >= p_i
-                      && root.release - parent.release >= parent.activity_duration // r_j - r_i >= p_i
-                      && root.deadline - parent.deadline >= root.activity_duration // d_j - d_i >= p_j
-                      )) {
-                    res = false;
-                    cout << "violation found: <" << i + 1 << "," << j + 1 << ">" << endl;
-                }
-                
-                double pmaxprogress = 1.0 / parent.activity_duration + 0.000001;
-                int pduration = 1.0 / pmaxprogress;
-                
-                if (!(parent.deadline - parent.release >= pduration  // d_i - r_i >= p_i
-                      && root.release - parent.release >= pduration // r_j - r_i >= p_i
-                      && root.deadline - parent.deadline >= rduration // d_j - d_i >= p_j
-                      )) {
-                    res = false;
-                    cout << "rounding violation found: <" << i + 1<< "," << j + 1<< ">" << endl;
-                }
+        assert(agg.p_max >= 0);
+        assert(agg.r_max >= 0);
+        assert(agg.d_max >= 0);
+        assert(X >= agg.p_max);
+        assert(Y >= X);
+    }
+    
+    assert(deadline - release >= duration);
+}
+
+/**
+ * @brief computes release and deadline of node j from its predecessors and its padding
+ * @details requires all predecessors of j to have their times computed already. Uses the formulas of generate_times or, if times were generated in horizon-minimising mode, of generate_bounded_times.
+ * 
+ * @param j index of node
+ * @return true if release or deadline of j changed
+ */
+bool RanGenFile::compute_times(const int j) {
+    using namespace std;
+    
+    node& n = G.v(j);
+    const int old_release = n.release;
+    const int old_deadline = n.deadline;
+    
+    // go through all parents
+    PredecessorAggregate agg;
+    const vector<int>& pred = G.predecessors(j);
+    for (vector<int>::const_iterator it = pred.begin(); it != pred.end(); ++it) {
+        node & parent = G.v(*it);
+        agg.add(parent.release, parent.deadline, parent.activity_duration, *it == 0);
+    }
+    
+    window(agg, n.activity_duration, n.pad_release, n.pad_deadline, _horizon_factor, n.release, n.deadline);
+    
+    return n.release != old_release || n.deadline != old_deadline;
+}
+
+/**
+ * @brief redraws the padding W, Z of node j
+ * @details the new padding takes effect with the next call of update_times.
+ * 
+ * @param j index of node
+ * @param limit time limit, see generate_times
+ * @param rnd random number generator to draw from
+ */
+void RanGenFile::resample_padding(const int j, const int limit, Random& rnd) {
+    int W, Z;
+    draw_padding(limit, rnd, W, Z);
+    if (j == 0)W = Z = 0;
+    G.v(j).pad_release = W;
+    G.v(j).pad_deadline = Z;
+}
+
+/**
+ * @brief computes the position of each node in topological order as used by update_times
+ * @return false if the graph has a cycle, the positions are left unchanged then
+ */
+bool RanGenFile::index_topological_order() {
+    using namespace std;
+    
+    vector<int> order;
+    if (!G.topologicalOrder(order))return false;
+    _topo_index.assign(node_count(), 0);
+    for (unsigned int k = 0; k < order.size(); k++)_topo_index[order[k]] = k;
+    _queued.assign(node_count(), 0);
+    return true;
+}
+
+/**
+ * @brief adds or removes edge <i, j>
+ * @details the topological order used by update_times is only recomputed if a new edge runs against it. As the predecessors of j change, j has to be passed to update_times afterwards.
+ * 
+ * @param i predecessor
+ * @param j successor
+ * @param present true to add the edge, false to remove it
+ * @return false if the edge would close a cycle, the graph is left unchanged then
+ */
+bool RanGenFile::set_edge(const int i, const int j, const bool present) {
+    assert(0 <= i && i < (int)node_count() && 0 <= j && j < (int)node_count());
+    
+    G.set(i, j, present ? 1 : 0);
+    if (!present || (_topo_index.size() == node_count() && _topo_index[i] < _topo_index[j]))return true;
+    
+    if (!index_topological_order()) {
+        G.set(i, j, 0);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief incrementally recomputes release and deadlines after local changes
+ * @details after generate_times, activity durations (via nodes), paddings (via resample_padding) or edges (via set_edge) of some nodes may be changed. Then only the changed nodes and the nodes reachable from them can obtain other times. These are recomputed in topological order using a heap keyed by topological position. Successors of a recomputed node are only visited if its release or deadline changed (early cut-off), except for the changed nodes themselves, as their duration enters the times of their successors.
+ * 
+ * @param changed indices of the nodes whose duration, padding or predecessors changed
+ * @return number of nodes recomputed
+ */
+int RanGenFile::update_times(const std::vector<int>& changed) {
+    using namespace std;
+    
+    if (_topo_index.size() != node_count())index_topological_order();
+    
+    // min heap of (topological position, node)
+    priority_queue<pair<int, int>, vector<pair<int, int> >, greater<pair<int, int> > > heap;
+    
+    // 1 = queued, 2 = queued and successors have to be visited regardless of cut-off
+    for (vector<int>::const_iterator it = changed.begin(); it != changed.end(); ++it) {
+        assert(0 <= *it && *it < (int)node_count());
+        if (!_queued[*it])heap.push(make_pair(_topo_index[*it], *it));
+        _queued[*it] = 2;
+    }
+    
+    int count = 0;
+    while (!heap.empty()) {
+        int j = heap.top().second;
+        heap.pop();
+        
+        bool force = _queued[j] == 2;
+        _queued[j] = 0;
+        count++;
+        
+        if (!compute_times(j) && !force)continue; // early cut-off
+        
+        const vector<int>& succ = G.successors(j);
+        for (vector<int>::const_iterator it = succ.begin(); it != succ.end(); ++it) {
+            if (!_queued[*it]) {
+                _queued[*it] = 1;
+                heap.push(make_pair(_topo_index[*it], *it));
+            }
+        }
+    }
+    
+    return count;
+}
+
+/**
+ * @brief checks update_times against a full recomputation
+ * @details applies edits random changes to generated times, each either a new duration, a new padding, a new or a removed edge of a random activity. After each change, the times are updated via update_times and compared with those of a copy recomputing all nodes in topological order. Edges closing a cycle are rejected by set_edge, edges are only removed if both activities keep other relations. As durations are kept, equal releases and deadlines imply equal slack as well.
+ * 
+ * @param edits number of changes to apply
+ * @param time_limit time limit to draw paddings with, see generate_times
+ * @param rnd random number generator to draw the changes from
+ * @param verbose set to true to report progress
+ * @return true if all updates matched the full recomputation
+ */
+bool RanGenFile::check_update_times(const int edits, const int time_limit, Random& rnd, const bool verbose) {
+    using namespace std;
+    
+    const int n = node_count();
+    if (n < 3)return true;
+    
+    vector<int> changed(1), order;
+    long long recomputed = 0;
+    for (int e = 0; e < edits; e++) {
+        // dummies are left out, their times are fixed
+        const int j = 1 + rnd.next(n - 2);
+        switch (rnd.next(4)) {
+            case 0:
+                G.v(j).activity_duration = rnd.next(11);
+                break;
+            case 1:
+                resample_padding(j, time_limit, rnd);
+                break;
+            case 2:
+                set_edge(1 + rnd.next(n - 2), j, true);
+                break;
+            default: {
+                const vector<int>& pred = G.predecessors(j);
+                if (pred.size() < 2)break;
+                const int i = pred[rnd.next((int)pred.size())];
+                if (G.successors(i).size() > 1)set_edge(i, j, false);
+                break;
             }
-            
         }
+        changed[0] = j;
+        recomputed += update_times(changed);
         
+        RanGenFile full(*this);
+        full.G.topologicalOrder(order);
+        for (vector<int>::const_iterator it = order.begin(); it != order.end(); ++it)full.compute_times(*it);
+        
+        for (int i = 0; i < n; i++) {
+            const node& a = G.v(i);
+            const node& b = full.G.v(i);
+            if (a.release != b.release || a.deadline != b.deadline) {
+                cout<<"error: update_times differs from full recomputation for activity "<<a.id<<" after change "<<e + 1
+                    <<" (release "<<a.release<<" vs. "<<b.release<<", deadline "<<a.deadline<<" vs. "<<b.deadline<<")"<<endl;
+                return false;
+            }
+        }
+    }
+    
+    if (verbose)cout<<edits<<" changes checked, "<<recomputed<<" of "<<(long long)edits * n<<" nodes recomputed"<<endl;
+    return true;
+}
+
+/**
+ * @brief returns the time horizon of the generated times
+ * @details the time horizon equals the latest deadline of all nodes. Only meaningful after generate_times has been called.
+ * @return latest deadline
+ */
+int RanGenFile::horizon() {
+    int maxtime = 0;
+    for(int i = 0; i < node_count(); i++)
+        maxtime = std::max(maxtime, G.v(i).deadline);
+    return maxtime;
+}
+
+/**
+ * @brief validates generated times by checking constraints.
+ * @details validates generated times w.r.t. given constraints, see validate_times(ValidationResult&, const int). Outputs furhtmerore each occurence
+ * @param verbose set to false to suppress the output of each violation
+ * @param threads number of threads to use
+ * @return true if genereated times do not violate constraints
+ */
+bool RanGenFile::validate_times(const bool verbose, const int threads) {
+    using namespace std;
+    
+    ValidationResult result;
+    bool res = validate_times(result, threads);
+    
+    if (verbose) {
+        for (vector<TimeViolation>::const_iterator it = result.violations.begin(); it != result.violations.end(); ++it) {
+            const char *prefix = it->rounding ? "rounding violation found: " : "violation found: ";
+            if (it->j < 0) {
+                int id = G.v(it->i).id;
+                cout << prefix << "d_" << id << " - r_" << id << " < p_" << id << endl;
+            }
+            else cout << prefix << "<" << it->i + 1 << "," << it->j + 1 << ">" << endl;
+        }
     }
     
     return res;
 }
 
+/**
+ * @brief validates generated times by checking constraints (1) - (3) in O(V + E)
+ * @details durations rounded as by the solver (via maxProgress) are computed once per node. Constraint (1) is checked per node, (2) and (3) per edge of an explicit edge list, both w.r.t. exact and rounded durations. The checks are branchless loops over flat arrays, which the compiler can vectorize, and are split into chunks processed by up to threads threads. Violations are collected into result instead of being printed.
+ * 
+ * @param result filled with all violations found
+ * @param threads number of threads to use
+ * @return true if genereated times do not violate constraints
+ */
+bool RanGenFile::validate_times(ValidationResult& result, const int threads) {
+    using namespace std;
+    
+    const int n = node_count();
+    
+    // flat per node data
+    vector<int> R(n), D(n), P(n), PR(n);
+    vector<int> src, dst;
+    for (int i = 0; i < n; i++) {
+        node& v = G.v(i);
+        R[i] = v.release;
+        D[i] = v.deadline;
+        P[i] = v.activity_duration;
+        
+        // duration as obtained by the solver from maxProgress
+        double maxprogress = 1.0 / v.activity_duration + 0.000001;
+        PR[i] = (int)(1.0 / maxprogress);
+        
+        const vector<int>& succ = G.successors(i);
+        for (vector<int>::const_iterator it = succ.begin(); it != succ.end(); ++it) {
+            src.push_back(i);
+            dst.push_back(*it);
+        }
+    }
+    const int m = (int)src.size();
+    
+    // bit 0: violation, bit 1: rounding violation
+    vector<unsigned char> node_flags(n), edge_flags(m);
+    
+    const int *r = R.empty() ? NULL : &R[0], *d = D.empty() ? NULL : &D[0];
+    const int *p = P.empty() ? NULL : &P[0], *pr = PR.empty() ? NULL : &PR[0];
+    const int *s = src.empty() ? NULL : &src[0], *t = dst.empty() ? NULL : &dst[0];
+    unsigned char *nf = node_flags.empty() ? NULL : &node_flags[0];
+    unsigned char *ef = edge_flags.empty() ? NULL : &edge_flags[0];
+    
+    // (1) d_j - r_j >= p_j
+    auto check_nodes = [=](const int b, const int e) {
+        for (int j = b; j < e; j++) {
+            int w = d[j] - r[j];
+            nf[j] = (unsigned char)((w < p[j]) | ((w < pr[j]) << 1));
+        }
+    };
+    
+    // (1) d_i - r_i >= p_i, (2) r_j - r_i >= p_i, (3) d_j - d_i >= p_j
+    auto check_edges = [=](const int b, const int e) {
+        for (int k = b; k < e; k++) {
+            const int i = s[k], j = t[k];
+            const int wi = d[i] - r[i], dr = r[j] - r[i], dd = d[j] - d[i];
+            int bad = (wi < p[i]) | (dr < p[i]) | (dd < p[j]);
+            int bad_rounded = (wi < pr[i]) | (dr < pr[i]) | (dd < pr[j]);
+            ef[k] = (unsigned char)(bad | (bad_rounded << 1));
+        }
+    };
+    
+    // spawning threads only pays off for large instances
+    const int min_chunk = 1 << 15;
+    int num_threads = max(1, min(threads, (n + m) / min_chunk));
+    
+    if (num_threads == 1) {
+        check_nodes(0, n);
+        check_edges(0, m);
+    }
+    else {
+        vector<thread> workers;
+        for (int k = 0; k < num_threads; k++) {
+            workers.push_back(thread([=]() {
+                check_nodes((int)((long long)n * k / num_threads), (int)((long long)n * (k + 1) / num_threads));
+                check_edges((int)((long long)m * k / num_threads), (int)((long long)m * (k + 1) / num_threads));
+            }));
+        }
+        for (vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+    }
+    
+    // collect violations
+    result.violations.clear();
+    for (int j = 0; j < n; j++) {
+        if (node_flags[j] & 1)result.violations.push_back(TimeViolation(j, -1, false));
+        if (node_flags[j] & 2)result.violations.push_back(TimeViolation(j, -1, true));
+    }
+    for (int k = 0; k < m; k++) {
+        if (edge_flags[k] & 1)result.violations.push_back(TimeViolation(src[k], dst[k], false));
+        if (edge_flags[k] & 2)result.violations.push_back(TimeViolation(src[k], dst[k], true));
+    }
+    
+    return result.ok();
+}
+
 /**
  * @brief validates parsed data of a Patterson file
  * @details function in order to validate Patterson file by checking if given input follows RanGen format and data parsed is consistent
@@ -338,3 +733,157 @@ bool RanGenFile::validate_file(const bool verbose) {
     
     return !err;
 }
+
+/**
+ * @brief performs a critical path analysis (CPM)
+ * @details computes in O(V + E) via a forward and a backward pass over a topological order the earliest start est and latest start lst of every node ignoring release and deadlines. As for the generated times, the dummy start node starts at 0 and all other nodes at 1 at the earliest. Latest starts are computed w.r.t. the critical path length, i.e. lst - est is the slack of a node and nodes with zero slack form the critical path(s). The nodes are left unchanged.
+ * 
+ * @param est set to the earliest start of each node
+ * @param lst set to the latest start of each node
+ * @return length of the critical path, i.e. earliest possible completion time of the project
+ */
+int RanGenFile::critical_path(std::vector<int>& est, std::vector<int>& lst) {
+    using namespace std;
+    
+    vector<int> order;
+    G.topologicalOrder(order);
+    assert(order.size() == node_count());
+    
+    est.assign(node_count(), 0);
+    lst.assign(node_count(), 0);
+    
+    // forward pass
+    int length = 0;
+    for (vector<int>::const_iterator it = order.begin(); it != order.end(); ++it) {
+        est[*it] = *it == 0 ? 0 : 1;
+        const vector<int>& pred = G.predecessors(*it);
+        for (vector<int>::const_iterator jt = pred.begin(); jt != pred.end(); ++jt)
+            est[*it] = max(est[*it], est[*jt] + G.v(*jt).activity_duration);
+        length = max(length, est[*it] + G.v(*it).activity_duration);
+    }
+    
+    // backward pass
+    for (vector<int>::const_reverse_iterator it = order.rbegin(); it != order.rend(); ++it) {
+        int lf = length; // latest finish
+        const vector<int>& succ = G.successors(*it);
+        for (vector<int>::const_iterator jt = succ.begin(); jt != succ.end(); ++jt)
+            lf = min(lf, lst[*jt]);
+        lst[*it] = lf - G.v(*it).activity_duration;
+        assert(lst[*it] >= est[*it]);
+    }
+    
+    return length;
+}
+
+/**
+ * @brief performs a critical path analysis (CPM) and stores est and lst in the nodes
+ * @details see critical_path(est, lst)
+ * @return length of the critical path, i.e. earliest possible completion time of the project
+ */
+int RanGenFile::critical_path() {
+    using namespace std;
+    
+    vector<int> est, lst;
+    int length = critical_path(est, lst);
+    for (unsigned int i = 0; i < node_count(); i++) {
+        G.v(i).est = est[i];
+        G.v(i).lst = lst[i];
+    }
+    return length;
+}
+
+/**
+ * @brief energetic reasoning for a single resource
+ * @details an activity j may progress with at most 1 / p_j per period, so of its energy demand_j x p_j at least demand_j x max(0, p_j - |[r_j, d_j) without [a, a + L)|) has to be spent within any interval [a, a + L). For a fixed length L this is a trapezoid in a with slopes demand_j, 0 and -demand_j, hence the minimal energies of all intervals of length L are obtained by a single sweep over a using prefix sums of the slope changes. Lengths 1, 2, 4, ... and the horizon are checked, i.e. O((V + horizon) x log(horizon)).
+ * 
+ * @param k index of resource to check
+ * @param conflict filled with the interval with the largest overload if one exists
+ * @return true if no overload was found
+ */
+bool RanGenFile::check_resource(const int k, ResourceConflict& conflict) {
+    using namespace std;
+    
+    const int H = horizon();
+    const long long C = _resource_availability[k];
+    
+    long long worst = 0; // largest overload found so far
+    vector<long long> slope_delta(H + 1, 0);
+    
+    for(int L = 1; L <= H; L = (L < H && 2 * L > H) ? H : 2 * L) {
+        const int last = H - L; // intervals [a, a + L) for a = 0..last
+        fill(slope_delta.begin(), slope_delta.begin() + last + 1, 0);
+        long long energy = 0, slope = 0; // energy of [0, L), slope of the energy at a = 0
+        
+        for(int j = 0; j < node_count(); j++) {
+            const node& n = G.v(j);
+            const long long demand = n.resource_requirements[k];
+            const int p = n.activity_duration;
+            if(demand <= 0 || p <= 0)continue;
+            
+            // rises up to lo, stays at plateau up to hi and falls afterwards
+            const int lo = min(n.release, n.deadline - L), hi = max(n.release, n.deadline - L);
+            const int plateau = p - max(0, n.deadline - L - n.release);
+            if(plateau <= 0)continue;
+            
+            energy += demand * max(0, plateau - max(0, lo) - max(0, -hi));
+            const int at[] = {lo - plateau + 1, lo + 1, hi + 1, hi + plateau + 1};
+            const long long delta[] = {demand, -demand, -demand, demand};
+            for(int i = 0; i < 4; i++) {
+                if(at[i] <= 0)slope += delta[i];
+                else if(at[i] <= last)slope_delta[at[i]] += delta[i];
+            }
+        }
+        
+        for(int a = 0; a <= last; a++) {
+            if(a > 0) {
+                slope += slope_delta[a];
+                energy += slope;
+            }
+            long long excess = energy - C * L;
+            if(excess > worst) {
+                worst = excess;
+                conflict.resource = k;
+                conflict.from = a;
+                conflict.to = a + L;
+                conflict.energy = energy;
+                conflict.capacity = C * L;
+            }
+        }
+        
+        if(L == H)break;
+    }
+    
+    return worst == 0;
+}
+
+/**
+ * @brief screens generated release/deadline windows for resource infeasibility
+ * @details performs energetic reasoning on intervals of exponentially growing lengths (see check_resource), resources are checked in parallel. The check is necessary only, i.e. passing it does not guarantee that a feasible schedule exists. Only meaningful after generate_times has been called.
+ * 
+ * @param conflicts filled with the most overloaded interval of each infeasible resource
+ * @param threads number of threads to use
+ * @return true if no resource is overloaded
+ */
+bool RanGenFile::check_resources(std::vector<ResourceConflict>& conflicts, const int threads) {
+    using namespace std;
+    
+    vector<ResourceConflict> res(resource_count());
+    vector<char> ok(resource_count(), 1);
+    atomic<int> next_resource(0);
+    
+    vector<thread> workers;
+    int num_threads = max(min(threads, (int)resource_count()), 1);
+    for(int t = 0; t < num_threads; t++) {
+        workers.push_back(thread([&]() {
+            for(int k = next_resource++; k < (int)resource_count(); k = next_resource++)
+                ok[k] = check_resource(k, res[k]);
+        }));
+    }
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+    
+    conflicts.clear();
+    for(unsigned int k = 0; k < resource_count(); k++)
+        if(!ok[k])conflicts.push_back(res[k]);
+    
+    return conflicts.empty();
+}
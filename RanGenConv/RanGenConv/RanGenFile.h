@@ -31,12 +31,83 @@ public:
     std::vector<int>    children;               /**< chidlren, indexing starts with 1 */
     int                 release;
     int                 deadline;
+    int                 est;                    /**< earliest start as computed by critical_path */
+    int                 lst;                    /**< latest start as computed by critical_path */
+    int                 pad_release;            /**< random padding W drawn by generate_times */
+    int                 pad_deadline;           /**< random padding Z drawn by generate_times */
     
-    node() : activity_duration(0), num_successors(0), release(0), deadline(0), id(-1) {
+    node() : activity_duration(0), num_successors(0), release(0), deadline(0), est(0), lst(0), pad_release(0), pad_deadline(0), id(-1) {
         
     }
 };
 
+/**
+ * @brief aggregate over the predecessors of a node as needed to compute its release and deadline
+ */
+class PredecessorAggregate {
+public:
+    int                 d_max;                  /**< max d_i over all predecessors i */
+    int                 r_max;                  /**< max r_i over all predecessors i */
+    int                 p_max;                  /**< max p_i over all predecessors i */
+    int                 ef_max;                 /**< max r_i + p_i over all predecessors i */
+    bool                dummy_parent;           /**< true if dummy start is a predecessor */
+    
+    PredecessorAggregate() : d_max(0), r_max(0), p_max(0), ef_max(0), dummy_parent(false) {}
+    
+    /**
+     * @brief adds a predecessor to the aggregate
+     * 
+     * @param release release r_i of the predecessor
+     * @param deadline deadline d_i of the predecessor
+     * @param duration duration p_i of the predecessor
+     * @param dummy true if the predecessor is the dummy start node
+     */
+    void add(const int release, const int deadline, const int duration, const bool dummy) {
+        d_max = std::max(d_max, deadline);
+        r_max = std::max(r_max, release);
+        p_max = std::max(p_max, duration);
+        ef_max = std::max(ef_max, release + duration);
+        dummy_parent = dummy_parent || dummy;
+    }
+};
+
+/**
+ * @brief violation of constraints (1) - (3) found by validate_times
+ */
+class TimeViolation {
+public:
+    int                 i;                      /**< node violating (1) or predecessor of violated edge <i, j>, starts with 0 */
+    int                 j;                      /**< successor of violated edge <i, j>, -1 for violations of (1) only */
+    bool                rounding;               /**< true if violated w.r.t. durations rounded via maxProgress */
+    
+    TimeViolation(const int _i, const int _j, const bool _rounding) : i(_i), j(_j), rounding(_rounding) {}
+};
+
+/**
+ * @brief collects all violations found by validate_times
+ */
+class ValidationResult {
+public:
+    std::vector<TimeViolation>  violations;
+    
+    bool                ok() const {return violations.empty();}
+};
+
+/**
+ * @brief describes an interval on which a resource is overloaded
+ * @details the activities' minimal energy (demand x periods) required within [from, to) exceeds the energy the resource can provide, i.e. capacity x (to - from).
+ */
+class ResourceConflict {
+public:
+    int                 resource;               /**< index of overloaded resource, starts with 0 */
+    int                 from;                   /**< start of the interval */
+    int                 to;                     /**< end of the interval (exclusive) */
+    long long           energy;                 /**< minimal energy required within [from, to) */
+    long long           capacity;               /**< energy available within [from, to) */
+    
+    ResourceConflict() : resource(-1), from(0), to(0), energy(0), capacity(0) {}
+};
+
 /**
  * @brief holds data of a given file in Pattersonformat
  * 
@@ -48,24 +119,45 @@ private:
     std::vector<int>        _resource_availability;     /**< vector containing availabilitys */
                                                         /**< of the num_resources resources */
     Graph<node>             G;                          /**< graph to store all information */
-    Adjacencymatrix         m;                          /**< adjacencymatrix corresponding to nodes */
+    double                  _horizon_factor;            /**< horizon factor times were generated with, 0 for default mode */
+    std::vector<int>        _topo_index;                /**< position of each node in topological order, used by update_times */
+    std::vector<char>       _queued;                    /**< scratch flags of update_times */
     
     // util functions
     bool                    parse_file(std::string filename);
-    bool                    build_adjmatrix(const std::vector<node>& V);
+    bool                    parse(std::istream& ifs, const std::string& filename);
+    bool                    build_graph(const std::vector<node>& V);
+    bool                    check_resource(const int k, ResourceConflict& conflict);
+    bool                    generate_bounded_times(const int time_limit, const double horizon_factor, Random& rnd);
+    bool                    compute_times(const int j);
+    bool                    index_topological_order();
     
 public:
-    RanGenFile():_bad(false) {}
+    RanGenFile():_bad(false), _horizon_factor(0.0) {}
     RanGenFile(std::string filename);
+    RanGenFile(std::istream& is, const std::string& name);
     ~RanGenFile();
     
     bool                    generate_times(const int time_limit);
-    bool                    validate_times();
+    bool                    generate_times(const int time_limit, Random& rnd, const double horizon_factor = 0.0);
+    void                    resample_padding(const int j, const int time_limit, Random& rnd);
+    static void             draw_padding(const int time_limit, Random& rnd, int& W, int& Z);
+    static void             window(const PredecessorAggregate& agg, const int duration, int W, int Z, const double horizon_factor, int& release, int& deadline);
+    int                     update_times(const std::vector<int>& changed);
+    bool                    set_edge(const int i, const int j, const bool present);
+    bool                    check_update_times(const int edits, const int time_limit, Random& rnd, const bool verbose);
+    bool                    validate_times(const bool verbose = true, const int threads = 1);
+    bool                    validate_times(ValidationResult& result, const int threads = 1);
     bool                    validate_file(const bool verbose);
+    int                     critical_path();
+    int                     critical_path(std::vector<int>& est, std::vector<int>& lst);
+    bool                    topological_order(std::vector<int>& order) const {return G.topologicalOrder(order);}
+    bool                    check_resources(std::vector<ResourceConflict>& conflicts, const int threads = 1);
     bool                    bad() {return _bad;}
     
     unsigned int            node_count() {return G.vertex_count();}
     unsigned int            resource_count() {return num_resources;}
+    int                     horizon();
     
     const std::vector<int>& resource_availability() {return _resource_availability;}
     
@@ -75,8 +167,8 @@ public:
     }
     
     /**
-     * @brief returns entry of adjacency matrix for edge <i, j>
-     * @details returns entry of adjacency matrix for edge <i, j>. Positive values mean edge <i, j> belongs to edge set
+     * @brief returns whether edge <i, j> exists
+     * @details looks up j in the sorted successor list of i, i.e. takes O(log deg(i)). Positive values mean edge <i, j> belongs to edge set
      * 
      * @param i predecessor
      * @param j successor
@@ -84,6 +176,15 @@ public:
      * @return value indicating if <i, j> belongs to edge set. (Positive means yes, 0 no)
      */
     unsigned char           get(const unsigned int i, const unsigned int j) {return G.get(i, j);}
+    
+    typedef Graph<node>::edge_iterator edge_iterator;
+    
+    unsigned int            edge_count() const {return G.edge_count();}
+    edge_iterator           edges_begin() const {return G.edges_begin();}
+    edge_iterator           edges_end() const {return G.edges_end();}
+    
+    const std::vector<int>& successors(const unsigned int i) const {return G.successors(i);}
+    const std::vector<int>& predecessors(const unsigned int i) const {return G.predecessors(i);}
 };
 
 
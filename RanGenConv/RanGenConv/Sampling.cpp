@@ -0,0 +1,214 @@
+//
+//  Sampling.cpp
+//  RanGenConv
+//
+
+#include "Sampling.h"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief returns the horizon below which a fraction p of all samples lies
+ * 
+ * @param p percentile as fraction in [0, 1]
+ * @return horizon percentile (nearest rank)
+ */
+int SampleStatistics::horizon_percentile(const double p) const {
+    if(horizons.empty())return 0;
+    int rank = (int)std::ceil(p * horizons.size());
+    rank = std::min(std::max(rank, 1), (int)horizons.size());
+    return horizons[rank - 1];
+}
+
+/**
+ * @brief returns the window width below which a fraction p of all windows lies
+ * 
+ * @param p percentile as fraction in [0, 1]
+ * @return window width percentile (nearest rank)
+ */
+int SampleStatistics::window_percentile(const double p) const {
+    if(window_count == 0)return 0;
+    long long rank = (long long)std::ceil(p * window_count);
+    rank = std::max(rank, 1LL);
+    long long seen = 0;
+    for(unsigned int w = 0; w < window_histogram.size(); w++) {
+        seen += window_histogram[w];
+        if(seen >= rank)return w;
+    }
+    return (int)window_histogram.size() - 1;
+}
+
+/**
+ * @brief prints percentile table of horizon and window widths together with the failure rate
+ * 
+ * @param stream where to print the statistics
+ */
+void SampleStatistics::print(FILE *stream) const {
+    const double p[] = {0.0, 0.05, 0.25, 0.5, 0.75, 0.95, 1.0};
+    const int np = sizeof(p) / sizeof(p[0]);
+    
+    fprintf(stream, "samples:             %d\n", samples);
+    fprintf(stream, "validation failures: %d (%.2f%%)\n", failures, 100.0 * failure_rate());
+    fprintf(stream, "%-10s %8s %8s %8s %8s %8s %8s %8s\n", "", "min", "p5", "p25", "p50", "p75", "p95", "max");
+    fprintf(stream, "%-10s", "horizon");
+    for(int i = 0; i < np; i++)fprintf(stream, " %8d", horizon_percentile(p[i]));
+    fprintf(stream, "\n%-10s", "window");
+    for(int i = 0; i < np; i++)fprintf(stream, " %8d", window_percentile(p[i]));
+    fprintf(stream, "\n");
+}
+
+/**
+ * @return number of threads to use if user did not specify any (at least 1)
+ */
+unsigned int default_thread_count() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * @brief runs generate_times repeatedly on copies of file and gathers statistics
+ * @details sample #k draws its random numbers from a generator seeded with seed + k, so results do not depend on the number of threads. Each thread works on its own copy of file, nothing is written to disk. The times stored in file itself are left untouched.
+ * 
+ * @param file parsed input file
+ * @param time_limit time limit passed to generate_times
+ * @param horizon_factor horizon factor passed to generate_times
+ * @param samples number of samples to draw
+ * @param threads number of worker threads
+ * @param seed base seed of the samples
+ * @param dummynodes set to true to include the dummy nodes into the window statistics
+ * @param stats statistics to fill
+ * @return true if no errors occured
+ */
+bool sample_times(RanGenFile& file, const int time_limit, const double horizon_factor, const int samples, const int threads, const unsigned int seed, const bool dummynodes, SampleStatistics& stats) {
+    using namespace std;
+    
+    if(samples <= 0 || threads <= 0)return false;
+    
+    int offset = dummynodes ? 0 : 1;
+    int num_threads = min(threads, samples);
+    
+    vector<SampleStatistics> partial(num_threads);
+    atomic<int> next_sample(0);
+    
+    vector<thread> workers;
+    for(int t = 0; t < num_threads; t++) {
+        workers.push_back(thread([&, t]() {
+            RanGenFile local(file);
+            SampleStatistics& res = partial[t];
+            Random rnd;
+            
+            for(int k = next_sample++; k < samples; k = next_sample++) {
+                rnd.seed(seed + k);
+                local.generate_times(time_limit, rnd, horizon_factor);
+                
+                res.samples++;
+                if(!local.validate_times(false))res.failures++;
+                res.horizons.push_back(local.horizon());
+                
+                for(int i = offset; i < (int)local.node_count() - offset; i++) {
+                    int w = max(local.nodes(i).deadline - local.nodes(i).release, 0);
+                    if(w >= (int)res.window_histogram.size())res.window_histogram.resize(w + 1, 0);
+                    res.window_histogram[w]++;
+                    res.window_count++;
+                }
+            }
+        }));
+    }
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+    
+    // merge results of the workers
+    stats = SampleStatistics();
+    for(vector<SampleStatistics>::const_iterator it = partial.begin(); it != partial.end(); ++it) {
+        stats.samples += it->samples;
+        stats.failures += it->failures;
+        stats.window_count += it->window_count;
+        stats.horizons.insert(stats.horizons.end(), it->horizons.begin(), it->horizons.end());
+        if(it->window_histogram.size() > stats.window_histogram.size())
+            stats.window_histogram.resize(it->window_histogram.size(), 0);
+        for(unsigned int w = 0; w < it->window_histogram.size(); w++)
+            stats.window_histogram[w] += it->window_histogram[w];
+    }
+    sort(stats.horizons.begin(), stats.horizons.end());
+    
+    return true;
+}
+
+/**
+ * @brief time limit of attempt #k of search_horizon
+ * @details attempts are grouped into rounds, round r consists of the 2r + 1 attempts r^2, ..., (r + 1)^2 - 1 and tries the limits time_limit, time_limit - 1, time_limit + 1, ..., time_limit - r, time_limit + r. Limits close to time_limit are hence tried most often, while the search still reaches far off limits.
+ */
+static int search_limit(const int k, const int time_limit) {
+    int r = (int)std::sqrt((double)k);
+    while((long long)r * r > k)r--;
+    while((long long)(r + 1) * (r + 1) <= k)r++;
+    const int i = k - r * r; // position within round
+    const int offset = i % 2 == 0 ? i / 2 : -(i + 1) / 2;
+    
+    // generate_times draws from [0, limit / 2), hence limits below 2 are not allowed
+    return std::max(time_limit + offset, 2);
+}
+
+/**
+ * @brief searches speculatively in parallel for a run of generate_times with a horizon in [lo, hi]
+ * @details attempt #k uses the seed seed + k and a time limit depending on k only (see search_limit). Attempts are handed out to the threads in ascending order. The first attempt hitting the band wins, i.e. once an attempt hit it, only the attempts before it are finished. The result is hence the same for any number of threads. The winning run can be reproduced by calling generate_times with the reported time limit and a Random seeded with the reported seed.
+ * 
+ * @param file parsed input file, left untouched
+ * @param lo lower bound of the horizon band
+ * @param hi upper bound of the horizon band
+ * @param time_limit time limit to center the search at
+ * @param horizon_factor horizon factor passed to generate_times
+ * @param max_attempts maximum number of attempts before giving up
+ * @param threads number of worker threads
+ * @param seed base seed of the attempts
+ * @param res result of the search
+ * @return true if a run within the band was found
+ */
+bool search_horizon(RanGenFile& file, const int lo, const int hi, const int time_limit, const double horizon_factor, const int max_attempts, const int threads, const unsigned int seed, HorizonSearchResult& res) {
+    using namespace std;
+    
+    res = HorizonSearchResult();
+    if(lo > hi || max_attempts <= 0 || threads <= 0)return false;
+    
+    atomic<int> next_attempt(0);
+    atomic<int> winner(max_attempts); // first attempt which hit the band so far
+    int horizon = 0; // horizon of the winner
+    mutex m;
+    
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.push_back(thread([&]() {
+            RanGenFile local(file);
+            Random rnd;
+            
+            for(int k = next_attempt++; k < winner; k = next_attempt++) {
+                rnd.seed(seed + k);
+                local.generate_times(search_limit(k, time_limit), rnd, horizon_factor);
+                int h = local.horizon();
+                
+                if(lo <= h && h <= hi && local.validate_times(false)) {
+                    lock_guard<mutex> lock(m);
+                    if(k < winner) {
+                        winner = k;
+                        horizon = h;
+                    }
+                    break;
+                }
+            }
+        }));
+    }
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+    
+    const int k = winner;
+    res.found = k < max_attempts;
+    res.attempts = res.found ? k + 1 : max_attempts;
+    if(res.found) {
+        res.seed = seed + k;
+        res.time_limit = search_limit(k, time_limit);
+        res.horizon = horizon;
+    }
+    
+    return res.found;
+}
@@ -0,0 +1,55 @@
+//
+//  Sampling.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Sampling_h
+#define RanGenConv_Sampling_h
+
+#include "RanGenFile.h"
+#include "helper.h"
+
+#include <vector>
+#include <cstdio>
+
+/**
+ * @brief statistics gathered over repeated generation of release/deadlines for one instance
+ * @details holds the horizon of every sample and a histogram of window widths (deadline - release) over all activities of all samples. Percentiles are computed by nearest rank.
+ */
+class SampleStatistics {
+public:
+    int                     samples;            /**< number of samples drawn */
+    int                     failures;           /**< number of samples which failed validation */
+    std::vector<int>        horizons;           /**< horizon of each sample, sorted ascending after sampling */
+    std::vector<long long>  window_histogram;   /**< number of windows per width */
+    long long               window_count;       /**< total number of windows in histogram */
+    
+    SampleStatistics() : samples(0), failures(0), window_count(0) {}
+    
+    int                     horizon_percentile(const double p) const;
+    int                     window_percentile(const double p) const;
+    double                  failure_rate() const {return samples > 0 ? failures / (double)samples : 0.0;}
+    
+    void                    print(FILE *stream) const;
+};
+
+/**
+ * @brief result of a search for a generation run whose horizon lies in a given band
+ */
+class HorizonSearchResult {
+public:
+    bool                    found;              /**< true if a run within the band was found */
+    unsigned int            seed;               /**< seed of the winning run */
+    int                     time_limit;         /**< time limit of the winning run */
+    int                     horizon;            /**< horizon of the winning run */
+    int                     attempts;           /**< number of attempts up to and including the winning one */
+    
+    HorizonSearchResult() : found(false), seed(0), time_limit(0), horizon(0), attempts(0) {}
+};
+
+unsigned int                default_thread_count();
+
+bool                        sample_times(RanGenFile& file, const int time_limit, const double horizon_factor, const int samples, const int threads, const unsigned int seed, const bool dummynodes, SampleStatistics& stats);
+bool                        search_horizon(RanGenFile& file, const int lo, const int hi, const int time_limit, const double horizon_factor, const int max_attempts, const int threads, const unsigned int seed, HorizonSearchResult& res);
+
+#endif
@@ -0,0 +1,154 @@
+//
+//  SharedMemory.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_SharedMemory_h
+#define RanGenConv_SharedMemory_h
+
+// header-only reader of instances published by RanGenConv to POSIX shared memory (outputfile shm:<name>).
+// Depends on BinaryFormat.h only, copy both to your solver's code base. Link with -lrt on older glibc.
+
+#include "BinaryFormat.h"
+
+#include <atomic>
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <time.h>
+#include <errno.h>
+#endif
+
+#define RGC_SHM_MAGIC "RGCSHM\0\0"
+#define RGC_SHM_VERSION 1
+
+#define RGC_SHM_STATE_WRITING 0u        /**< segment exists, instance is being copied */
+#define RGC_SHM_STATE_READY 1u          /**< instance is complete */
+
+/**
+ * @brief header at the start of a shared memory segment, followed by a binary instance (see BinaryFormat.h)
+ * @details the writer creates the segment in state RGC_SHM_STATE_WRITING, copies the instance and sets the state to RGC_SHM_STATE_READY last, hence readers have to check the state before accessing the instance.
+ */
+struct SharedSegmentHeader {
+    char                magic[8];       /**< RGC_SHM_MAGIC */
+    uint32_t            version;        /**< RGC_SHM_VERSION */
+    volatile uint32_t   state;          /**< RGC_SHM_STATE_* */
+    uint64_t            offset;         /**< offset of the binary instance, multiple of RGC_BINARY_ALIGNMENT */
+    uint64_t            size;           /**< size of the binary instance in bytes */
+    uint64_t            seed;           /**< seed the times were generated with */
+    char                reserved[24];
+};
+
+/**
+ * @brief binary instance read from a POSIX shared memory segment
+ * @details open maps the segment read-only and attaches a BinaryInstance to it, i.e. nothing is copied or parsed. The segment stays in place until it is removed via unlink, even after the writer terminated.
+ */
+class SharedInstance {
+    const unsigned char    *_data;
+    size_t                  _length;
+    BinaryInstance          _instance;
+
+    // not copyable
+    SharedInstance(const SharedInstance& other);
+    SharedInstance& operator = (const SharedInstance& other);
+
+#if !defined(WIN32) && !defined(_WIN32)
+    static void             pause() {
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+    }
+
+    /**
+     * @brief maps segment if it exists and holds a complete instance
+     * @return 1 on success, 0 if segment is missing or not ready yet, -1 if it is invalid
+     */
+    int                     attach(const char *name) {
+        int fd = shm_open(name, O_RDONLY, 0);
+        if(fd < 0)return errno == ENOENT ? 0 : -1;
+        struct stat st;
+        if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedSegmentHeader)) {
+            ::close(fd);
+            return 0; // size is set by the writer right after creating the segment
+        }
+        _length = (size_t)st.st_size;
+        void *p = mmap(NULL, _length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // mapping stays valid
+        if(p == MAP_FAILED)return -1;
+        _data = (const unsigned char *)p;
+
+        const SharedSegmentHeader *header = (const SharedSegmentHeader *)_data;
+        static const char unwritten[8] = {0};
+        if(memcmp(header->magic, RGC_SHM_MAGIC, 8) != 0 || header->version != RGC_SHM_VERSION) {
+            // a new segment is zero filled until the writer wrote the header
+            const int res = memcmp(header->magic, unwritten, 8) == 0 ? 0 : -1;
+            close();
+            return res;
+        }
+        if(header->state != RGC_SHM_STATE_READY) {
+            close();
+            return 0;
+        }
+        // instance is read only after the state
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(header->offset > _length || header->size > _length - header->offset || !_instance.open(_data + header->offset, (size_t)header->size)) {
+            close();
+            return -1;
+        }
+        return 1;
+    }
+#endif
+
+public:
+    SharedInstance():_data(NULL), _length(0) {}
+    ~SharedInstance() {close();}
+
+    /**
+     * @brief maps shared memory segment and checks the header of the instance (see BinaryInstance::validate)
+     *
+     * @param name name of the segment as given to RanGenConv (shm:<name>), starting with /
+     * @param timeout_ms time in milliseconds to wait for the segment to appear and become ready, 0 to check once
+     * @return true if the segment holds a complete, valid instance
+     */
+    bool open(const char *name, const unsigned int timeout_ms = 0) {
+        close();
+#if defined(WIN32) || defined(_WIN32)
+        return false; // POSIX shared memory is not available
+#else
+        for(unsigned int waited = 0;; waited++) {
+            int res = attach(name);
+            if(res != 0)return res > 0;
+            if(waited >= timeout_ms)return false;
+            pause();
+        }
+#endif
+    }
+
+    /**
+     * @brief unmaps the segment, all views obtained before become invalid. The segment itself is not removed.
+     */
+    void close() {
+        _instance.close();
+#if !defined(WIN32) && !defined(_WIN32)
+        if(_data)munmap((void *)_data, _length);
+#endif
+        _data = NULL;
+        _length = 0;
+    }
+
+    /**
+     * @brief removes segment name, mappings of readers stay valid until they are closed
+     * @return true if segment existed and was removed
+     */
+    static bool unlink(const char *name) {
+#if defined(WIN32) || defined(_WIN32)
+        return false;
+#else
+        return shm_unlink(name) == 0;
+#endif
+    }
+
+    bool                    is_open() const {return _instance.is_open();}
+    const BinaryInstance&   instance() const {return _instance;}
+    uint64_t                seed() const {return ((const SharedSegmentHeader *)_data)->seed;}
+};
+
+#endif
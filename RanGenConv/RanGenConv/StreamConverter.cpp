@@ -0,0 +1,327 @@
+//
+//  StreamConverter.cpp
+//  RanGenConv
+//
+
+#include "StreamConverter.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+StreamConverter::StreamConverter(const int time_limit, const double horizon_factor, const unsigned int seed, const bool dummynodes, const bool compact, const bool windows):
+_time_limit(time_limit), _horizon_factor(horizon_factor), _dummynodes(dummynodes), _compact(compact), _windows(windows), _rnd(seed), _horizon(0), _max_frontier(0) {
+    
+}
+
+/**
+ * @brief appends contents of temporary file src to dst
+ * 
+ * @param dst sink to write to
+ * @param src sink of temporary file to read from, is flushed and rewound first
+ * @param file temporary file src writes to
+ * @return true if no errors occured
+ */
+bool StreamConverter::append(OutputSink& dst, OutputSink& src, FILE *file) {
+    char buffer[1 << 16];
+    size_t n = 0;
+    
+    if(!src.flush())return false;
+    rewind(file);
+    while((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        dst.write(buffer, n);
+    
+    return !ferror(file) && dst.good();
+}
+
+/**
+ * @brief parses input file and writes output file in a single pass
+ * @details produces the same file layout as generate_output. Random draws are taken in order of activity ids, hence for a given seed the times differ from those of the regular mode which draws in order of a DFS based topological sort.
+ * 
+ * @param ifilename path to input file in Patterson format
+ * @param ofilename path to output file
+ * @param verbose set to true to display additional messages
+ * @param compression compression of the output file
+ * @return true if no errors occured
+ */
+bool StreamConverter::convert(const char *ifilename, const char *ofilename, const bool verbose, const CompressionMethod compression) {
+    using namespace std;
+    
+    ifstream ifs(ifilename);
+    if(ifs.fail() || ifs.bad()) {
+        cout<<"error: "<<"file could not been opened successfully"<<endl;
+        return false;
+    }
+    
+    // one temporary file per block whose length depends on the activities
+    FILE *bprogress = tmpfile();
+    FILE *brelations = tmpfile();
+    FILE *brelease = tmpfile();
+    FILE *bdeadline = tmpfile();
+    FILE *bdemand = tmpfile();
+    FILE *bwindow = tmpfile();
+    FILE *blocks[] = {bprogress, brelations, brelease, bdeadline, bdemand, bwindow};
+    const int num_blocks = sizeof(blocks) / sizeof(blocks[0]);
+    
+    bool res = true;
+    for(int i = 0; i < num_blocks; i++)
+        if(!blocks[i]) {
+            cout<<"error: temporary file could not be created"<<endl;
+            res = false;
+        }
+    
+    // buffers of the blocks
+    const size_t block_capacity = 1 << 16;
+    OutputSink sprogress(bprogress, block_capacity);
+    OutputSink srelations(brelations, block_capacity);
+    OutputSink srelease(brelease, block_capacity);
+    OutputSink sdeadline(bdeadline, block_capacity);
+    OutputSink sdemand(bdemand, block_capacity);
+    OutputSink swindow(bwindow, block_capacity);
+    
+    int line_number = 0;
+    int num_nodes = 0;
+    int num_resources = 0;
+    vector<int> availability;
+    vector<int> demands;
+    vector<int> successors;
+    
+    int id = 1;
+    int emitted = 0;
+    long long positive_demands = 0;
+    long long window_vars = 0;
+    bool first_relation = true;
+    const int offset = _dummynodes ? 0 : 1;
+    
+    _frontier.clear();
+    _horizon = 0;
+    _max_frontier = 0;
+    
+    for (string line; res && getline(ifs, line); )
+    {
+        // go over empty lines
+        if(line.length() < 2)continue;
+        
+        stringstream ss(line);
+        
+        // zero line
+        if(line_number == 0) {
+            ss >> num_nodes >> num_resources;
+        }
+        // second line
+        else if(line_number == 1) {
+            int a = 0;
+            for(int i = 0; i < num_resources; ++i) {
+                ss >> a;
+                availability.push_back(a);
+            }
+        }
+        else {
+            int duration = 0;
+            int num_successors = 0;
+            ss >> duration;
+            demands.assign(num_resources, 0);
+            for(int i = 0; i < num_resources; i++)ss >> demands[i];
+            ss >> num_successors;
+            successors.assign(num_successors, 0);
+            for(int i = 0; i < num_successors; i++)ss >> successors[i];
+            // relations are written in ascending order like in the regular mode
+            sort(successors.begin(), successors.end());
+            
+            if(ss.fail()) {
+                cout<<"error: line #"<<line_number<<" could not be parsed"<<endl;
+                res = false;
+                break;
+            }
+            
+            // all predecessors have been read, i.e. aggregate is final
+            PredecessorAggregate agg;
+            map<int, PredecessorAggregate>::iterator it = _frontier.find(id);
+            if(it != _frontier.end()) {
+                agg = it->second;
+                _frontier.erase(it);
+            }
+            
+            int W, Z;
+            RanGenFile::draw_padding(_time_limit, _rnd, W, Z);
+            
+            // special case, first dummy node will have everything set to zero!!!
+            if(id == 1)W = Z = 0;
+            
+            int release, deadline;
+            RanGenFile::window(agg, duration, W, Z, _horizon_factor, release, deadline);
+            _horizon = max(_horizon, deadline);
+            
+            for(vector<int>::const_iterator jt = successors.begin(); jt != successors.end(); ++jt) {
+                if(*jt <= id || *jt > num_nodes) {
+                    cout<<"error: successor "<<*jt<<" of activity "<<id<<" is out of order, file cannot be streamed"<<endl;
+                    res = false;
+                    break;
+                }
+                _frontier[*jt].add(release, deadline, duration, id == 1);
+                
+                // skip relations from/to dummy nodes if disabled
+                if(!_dummynodes && (id == 1 || *jt == num_nodes))continue;
+                if(!first_relation)srelations<<',';
+                srelations<<'<'<<(id - offset)<<','<<(*jt - offset)<<'>';
+                first_relation = false;
+            }
+            _max_frontier = max(_max_frontier, _frontier.size());
+            
+            // emit window of finished activity
+            if(_dummynodes || (id != 1 && id != num_nodes)) {
+                if(emitted > 0) {
+                    sprogress<<',';
+                    srelease<<',';
+                    sdeadline<<',';
+                }
+                sprogress.write_double(1.0 / duration + 0.000001, 6);
+                srelease<<release;
+                sdeadline<<deadline;
+                if(_windows) {
+                    if(emitted > 0)swindow<<',';
+                    swindow<<'<'<<(release + 1)<<','<<deadline<<'>';
+                    window_vars += max(deadline - release, 0);
+                }
+                emitted++;
+                
+                // compact output lists only positive demands as tuples <activity, resource, demand>
+                if(_compact) {
+                    for(int i = 0; i < num_resources; i++) {
+                        if(demands[i] == 0)continue;
+                        if(positive_demands > 0)sdemand<<',';
+                        sdemand<<'<'<<emitted<<','<<(i + 1)<<','<<demands[i]<<'>';
+                        positive_demands++;
+                    }
+                }
+                else {
+                    if(emitted > 1)sdemand<<',';
+                    sdemand<<'[';
+                    for(int i = 0; i < num_resources; i++) {
+                        if(i > 0)sdemand<<',';
+                        sdemand<<demands[i];
+                    }
+                    sdemand<<']';
+                }
+            }
+            
+            id++;
+        }
+        
+        line_number++;
+    }
+    
+    if(res && id - 1 != num_nodes) {
+        cout<<"error: found "<<(id - 1)<<" activities, but "<<num_nodes<<" were announced"<<endl;
+        res = false;
+    }
+    if(res && num_resources <= 0) {
+        cout<<"error: no resources found"<<endl;
+        res = false;
+    }
+    
+    if(verbose && res)cout<<"parsed and generated "<<num_nodes<<" activities, at most "<<_max_frontier<<" pending"<<endl;
+    
+    // assemble output file
+    OutputSink out;
+    if(res && !out.open(ofilename, false, false, compression)) {
+        cout<<"error: output file could not been opened"<<endl;
+        res = false;
+    }
+    
+    if(res) {
+        const int maxtime = _horizon;
+        const int activity_count = _dummynodes ? num_nodes : num_nodes - 2;
+        
+        if(_compact) {
+            // see generate_output
+            out<<"time = "<<offset<<".."<<maxtime<<";\n";
+            out<<"activity = 1.."<<activity_count<<";\n";
+            out<<"resource = 1.."<<num_resources<<";\n";
+            out<<"horizon = "<<maxtime<<";\n";
+            out<<"res_capacity = [";
+            for(int j = 0; j < num_resources; j++) {
+                if(j > 0)out<<',';
+                out<<availability[j];
+            }
+            out<<"];\n";
+        }
+        else {
+            // time
+            out<<"time = {";
+            for(int i = offset; i < maxtime; i++)out<<i<<',';
+            out<<maxtime<<"};\n";
+        
+            // activity
+            out<<"activity = {";
+            for(int i = 1; i < activity_count; i++)out<<i<<',';
+            out<<activity_count<<"};\n";
+        
+            // resource
+            out<<"resource = {";
+            for(int i = 1; i < num_resources; i++)out<<i<<',';
+            out<<num_resources<<"};\n";
+        
+            // (overall) resource capacity (constant)
+            out<<"res_capacity = [";
+            for(int t = 1; t <= maxtime; t++) {
+                out<<'[';
+                for(int j = 0; j < num_resources; j++) {
+                    if(j > 0)out<<',';
+                    out<<availability[j];
+                }
+                out<<(t < maxtime ? "]," : "]];\n");
+            }
+        
+        }
+        
+        out<<"maxProgress  = [";
+        res = res && append(out, sprogress, bprogress);
+        out<<"];\n";
+        
+        out<<"minProgress  = [";
+        for(int i = 1; i < activity_count; i++)out<<0.0<<',';
+        out<<0.0<<"];\n";
+        
+        out<<"Relations  = {";
+        res = res && append(out, srelations, brelations);
+        out<<"};\n";
+        
+        out<<"release  = [";
+        res = res && append(out, srelease, brelease);
+        out<<"];\n";
+        
+        out<<"deadline  = [";
+        res = res && append(out, sdeadline, bdeadline);
+        out<<"];\n";
+        
+        if(_windows) {
+            out<<"window  = [";
+            res = res && append(out, swindow, bwindow);
+            out<<"];\n";
+            out<<"window_vars = "<<window_vars<<";\n";
+        }
+        
+        out<<(_compact ? "res_demand = {" : "res_demand = [");
+        res = res && append(out, sdemand, bdemand);
+        out<<(_compact ? "};\n" : "];\n");
+        
+        if(!out.close() || !res) {
+            cout<<"error: bad file operation occured while writing output"<<endl;
+            res = false;
+        }
+    }
+    
+    // detach buffers before their files are closed
+    OutputSink *sinks[] = {&sprogress, &srelations, &srelease, &sdeadline, &sdemand, &swindow};
+    for(int i = 0; i < num_blocks; i++) {
+        sinks[i]->close();
+        if(blocks[i])fclose(blocks[i]);
+    }
+    
+    if(verbose && res)cout<<"file successfully converted, time horizon is "<<_horizon<<" periods long"<<endl;
+    
+    return res;
+}
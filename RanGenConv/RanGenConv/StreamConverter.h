@@ -0,0 +1,45 @@
+//
+//  StreamConverter.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_StreamConverter_h
+#define RanGenConv_StreamConverter_h
+
+#include "RanGenFile.h"
+#include "helper.h"
+#include "OutputSink.h"
+
+#include <string>
+#include <map>
+#include <cstdio>
+
+/**
+ * @brief converts Patterson files in one pass without building the graph
+ * @details requires that successors always have higher ids than their predecessors, as is the case for files written by RanGen. Then all predecessors of an activity have been read when its line is parsed, so its release and deadline can be computed from aggregates which are updated whenever a predecessor is read. Only aggregates of activities having a parsed predecessor but not been parsed themselves (the frontier) are kept in memory. Blocks of the output file are streamed to temporary files and assembled at the end, once the horizon is known.
+ */
+class StreamConverter {
+private:
+    int                     _time_limit;
+    double                  _horizon_factor;
+    bool                    _dummynodes;
+    bool                    _compact;           /**< write compact layout, see generate_output */
+    bool                    _windows;           /**< write feasible periods, see generate_output */
+    Random                  _rnd;
+    int                     _horizon;           /**< latest deadline seen */
+    size_t                  _max_frontier;      /**< maximum number of pending aggregates */
+    
+    std::map<int, PredecessorAggregate> _frontier; /**< pending aggregates by activity id */
+    
+    bool                    append(OutputSink& dst, OutputSink& src, FILE *file);
+    
+public:
+    StreamConverter(const int time_limit, const double horizon_factor, const unsigned int seed, const bool dummynodes, const bool compact = false, const bool windows = false);
+    
+    bool                    convert(const char *ifilename, const char *ofilename, const bool verbose, const CompressionMethod compression = COMPRESSION_NONE);
+    
+    int                     horizon() const {return _horizon;}
+    size_t                  max_frontier() const {return _max_frontier;}
+};
+
+#endif
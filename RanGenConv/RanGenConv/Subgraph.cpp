@@ -0,0 +1,171 @@
+//
+//  Subgraph.cpp
+//  RanGenConv
+//
+
+#include "Subgraph.h"
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdio>
+
+/**
+ * @brief parses a subgraph given on the commandline
+ * @details spec is one of hops:k:id,id,... (nodes within k edges of the given nodes), levels:lo:hi (progressive levels lo..hi) or critical (critical path(s) plus their predecessors and successors)
+ *
+ * @param spec textual description of the subgraph
+ * @return false if spec is malformed
+ */
+bool SubgraphSpec::parse(const std::string& spec) {
+    using namespace std;
+
+    if(spec == "critical") {
+        mode = SUBGRAPH_CRITICAL;
+        return true;
+    }
+    if(spec.compare(0, 7, "levels:") == 0) {
+        mode = SUBGRAPH_LEVELS;
+        return sscanf(spec.c_str() + 7, "%d:%d", &lo, &hi) == 2 && 0 <= lo && lo <= hi;
+    }
+    if(spec.compare(0, 5, "hops:") == 0) {
+        mode = SUBGRAPH_HOPS;
+        size_t colon = spec.find(':', 5);
+        if(colon == string::npos || sscanf(spec.c_str() + 5, "%d", &hops) != 1 || hops < 0)return false;
+        stringstream list(spec.substr(colon + 1));
+        string id;
+        centers.clear();
+        while(getline(list, id, ','))centers.push_back(atoi(id.c_str()));
+        return !centers.empty();
+    }
+    return false;
+}
+
+/**
+ * @brief nodes within hops edges of the centers, visiting only these nodes and their edges
+ */
+static bool select_hops(RanGenFile& file, const SubgraphSpec& spec, const bool dummynodes, std::vector<int>& nodes) {
+    using namespace std;
+
+    const int n = file.node_count();
+    unordered_map<int, int> distance;
+    vector<int> queue;
+    for(vector<int>::const_iterator it = spec.centers.begin(); it != spec.centers.end(); ++it) {
+        const bool dummy = *it == 0 || *it == n - 1;
+        if(*it < 0 || *it >= n || (dummy && !dummynodes)) {
+            cout<<"error: node "<<*it<<" does not exist"<<(dummy ? " (dummy nodes are not written)" : "")<<endl;
+            return false;
+        }
+        if(distance.insert(make_pair(*it, 0)).second)queue.push_back(*it);
+    }
+
+    // breadth first search ignoring edge directions, queue holds the result. Dummies are adjacent to every source / sink, hence they are expanded only if they are centers
+    for(size_t head = 0; head < queue.size(); head++) {
+        const int v = queue[head], d = distance[v];
+        if(d >= spec.hops || (d > 0 && (v == 0 || v == n - 1)))continue;
+        for(int dir = 0; dir < 2; dir++) {
+            const vector<int>& adjacent = dir == 0 ? file.successors(v) : file.predecessors(v);
+            for(vector<int>::const_iterator it = adjacent.begin(); it != adjacent.end(); ++it) {
+                if(!dummynodes && (*it == 0 || *it == n - 1))continue;
+                if(distance.insert(make_pair(*it, d + 1)).second)queue.push_back(*it);
+            }
+        }
+    }
+    nodes.swap(queue);
+    return true;
+}
+
+/**
+ * @brief nodes on levels lo..hi
+ * @details levels are assigned layer by layer starting from the dummy start, a node is placed once its last predecessor was. Stops after level hi, i.e. visits only nodes up to level hi + 1.
+ */
+static bool select_levels(RanGenFile& file, const SubgraphSpec& spec, const bool dummynodes, std::vector<int>& nodes) {
+    using namespace std;
+
+    const int n = file.node_count();
+    unordered_map<int, int> remaining; // number of predecessors not placed yet
+    vector<int> layer(1, 0), next;
+    if(dummynodes && spec.lo == 0)nodes.push_back(0);
+
+    for(int level = 0; !layer.empty() && level <= spec.hi; level++) {
+        next.clear();
+        for(vector<int>::const_iterator it = layer.begin(); it != layer.end(); ++it) {
+            const vector<int>& succ = file.successors(*it);
+            for(vector<int>::const_iterator jt = succ.begin(); jt != succ.end(); ++jt) {
+                unordered_map<int, int>::iterator r = remaining.insert(make_pair(*jt, (int)file.predecessors(*jt).size())).first;
+                if(--r->second > 0)continue;
+                // dummy end shares the level of its highest predecessor
+                if(*jt == n - 1) {
+                    if(dummynodes && spec.lo <= level)nodes.push_back(*jt);
+                    continue;
+                }
+                next.push_back(*jt);
+                if(spec.lo <= level + 1 && level + 1 <= spec.hi)nodes.push_back(*jt);
+            }
+        }
+        layer.swap(next);
+    }
+    return true;
+}
+
+/**
+ * @brief nodes without slack, their predecessors and successors
+ * @details slack is computed via RanGenFile::critical_path without overwriting est / lst of the nodes
+ */
+static bool select_critical(RanGenFile& file, const bool dummynodes, std::vector<int>& nodes) {
+    using namespace std;
+
+    const int n = file.node_count();
+    vector<int> order;
+    // critical_path requires an acyclic graph
+    if(!file.topological_order(order))return false;
+
+    vector<int> est, lst;
+    file.critical_path(est, lst);
+
+    vector<char> selected(n, 0);
+    for(int v = 1; v < n - 1; v++) {
+        if(est[v] != lst[v])continue;
+        selected[v] = 1;
+        for(int dir = 0; dir < 2; dir++) {
+            const vector<int>& adjacent = dir == 0 ? file.successors(v) : file.predecessors(v);
+            for(vector<int>::const_iterator it = adjacent.begin(); it != adjacent.end(); ++it)selected[*it] = 1;
+        }
+    }
+    if(dummynodes)selected[0] = selected[n - 1] = 1;
+    else selected[0] = selected[n - 1] = 0;
+    for(int v = 0; v < n; v++)
+        if(selected[v])nodes.push_back(v);
+    return true;
+}
+
+/**
+ * @brief computes the nodes of the subgraph
+ *
+ * @param file instance
+ * @param dummynodes set to true if dummy start and end are written
+ * @param nodes set to the ids of the nodes of the subgraph in ascending order
+ * @return false if the subgraph could not be determined, e.g. a center does not exist
+ */
+bool SubgraphSpec::select(RanGenFile& file, const bool dummynodes, std::vector<int>& nodes) const {
+    nodes.clear();
+    bool res = false;
+    switch(mode) {
+        case SUBGRAPH_HOPS:
+            res = select_hops(file, *this, dummynodes, nodes);
+            break;
+        case SUBGRAPH_LEVELS:
+            res = select_levels(file, *this, dummynodes, nodes);
+            break;
+        case SUBGRAPH_CRITICAL:
+            res = select_critical(file, dummynodes, nodes);
+            break;
+        default:
+            for(int v = dummynodes ? 0 : 1; v < file.node_count() - (dummynodes ? 0 : 1); v++)nodes.push_back(v);
+            res = true;
+            break;
+    }
+    std::sort(nodes.begin(), nodes.end());
+    return res;
+}
@@ -0,0 +1,42 @@
+//
+//  Subgraph.h
+//  RanGenConv
+//
+
+#ifndef RanGenConv_Subgraph_h
+#define RanGenConv_Subgraph_h
+
+#include "RanGenFile.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief kinds of subgraphs to export instead of the full network
+ */
+enum SubgraphMode {
+    SUBGRAPH_ALL = 0,                   /**< full network */
+    SUBGRAPH_HOPS,                      /**< nodes within hops edges of the centers, ignoring edge directions */
+    SUBGRAPH_LEVELS,                    /**< nodes on progressive levels lo..hi */
+    SUBGRAPH_CRITICAL                   /**< nodes without slack plus their predecessors and successors */
+};
+
+/**
+ * @brief selection of the nodes written to GraphML
+ * @details nodes are given by their ids in the GraphML output, i.e. n<id>. The dummies are never expanded, as they are adjacent to all sources / sinks, and are part of the subgraph only if dummynodes is set. Progressive levels are counted as by the metrics: the first activities are on level 1, each activity is one level above its highest predecessor.
+ */
+class SubgraphSpec {
+public:
+    SubgraphMode            mode;
+    std::vector<int>        centers;        /**< nodes to start from (SUBGRAPH_HOPS) */
+    int                     hops;           /**< radius (SUBGRAPH_HOPS) */
+    int                     lo;             /**< lowest level (SUBGRAPH_LEVELS) */
+    int                     hi;             /**< highest level (SUBGRAPH_LEVELS) */
+
+    SubgraphSpec():mode(SUBGRAPH_ALL), hops(0), lo(0), hi(0) {}
+
+    bool                    parse(const std::string& spec);
+    bool                    select(RanGenFile& file, const bool dummynodes, std::vector<int>& nodes) const;
+};
+
+#endif
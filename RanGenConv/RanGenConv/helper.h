@@ -14,6 +14,12 @@
 #include <cmath>
 #include <cstdio>
 #include <algorithm>
+#include <random>
+#include <vector>
+#include <thread>
+
+// version of the converter as recorded in batch manifests, increase whenever the output for a given input and options changes
+#define RANGENCONV_VERSION "1.0"
 
 #ifndef DEBUG
 #ifdef _DEBUG
@@ -56,4 +62,82 @@ inline int georv(const double rate) {
     return max((int)floor(log(drandom(0.0, 1.0)) / log(1.0 - rate)), 0);
 }
 
+/**
+ * @brief pseudo random number generator owning its state
+ * @details unlike rand(), which shares one global state, every Random object carries its own engine. Use one object per thread whenever times are generated concurrently. Equal seeds yield equal sequences, i.e. a generation run can be reproduced from its seed.
+ */
+class Random {
+private:
+    std::mt19937 _engine;
+public:
+    Random(const unsigned int seed = 0) : _engine(seed) {}
+    
+    /**
+     * @brief resets the engine to a given seed
+     * 
+     * @param seed new seed of the engine
+     */
+    void seed(const unsigned int seed) { _engine.seed(seed); }
+    
+    /**
+     * @brief returns uniformly distributed integer on [0, n - 1]
+     * 
+     * @param n number of possible values, has to be positive
+     * @return realisation of uniformly distributed random variable on [0, n - 1]
+     */
+    int next(const int n) {
+        assert(n > 0);
+        return (int)(_engine() % (unsigned int)n);
+    }
+    
+    /**
+     * @brief returns double random variable uniformly distributed on [dmin, dmax]
+     * 
+     * @param dmin lower bound of interval
+     * @param dmax upper bound of interval
+     * 
+     * @return realisation of uniformly distributed random variable on [dmin, dmax]
+     */
+    double uniform(const double dmin, const double dmax) {
+        return dmin + (dmax - dmin) * (_engine() / (double)std::mt19937::max());
+    }
+    
+    /**
+     * @brief draw of geometric distributed random variable
+     * @details same as georv, but uses the own engine instead of rand()
+     * 
+     * @param rate rate of the geometric distribution
+     * @return realisation of a geometric distributed random variable
+     */
+    int geometric(const double rate) {
+        using namespace std;
+        assert(rate >= 0);
+        // dont forget max, as random generator can return 0
+        return max((int)floor(log(uniform(0.0, 1.0)) / log(1.0 - rate)), 0);
+    }
+};
+
+/**
+ * @brief calls func(begin, end) on disjoint chunks of [0, count) using up to threads threads
+ * @details chunks hold at least min_chunk elements, so small ranges are processed on the calling thread.
+ */
+template<typename F> void parallel_for(const int count, const int threads, const int min_chunk, F func) {
+    using namespace std;
+
+    int num_threads = max(min(threads, count / max(min_chunk, 1)), 1);
+    if(num_threads == 1) {
+        func(0, count);
+        return;
+    }
+
+    int chunk = (count + num_threads - 1) / num_threads;
+    vector<thread> workers;
+    for(int t = 1; t < num_threads; t++) {
+        int begin = min(t * chunk, count), end = min(begin + chunk, count);
+        workers.push_back(thread([=, &func]() {func(begin, end);}));
+    }
+    func(0, min(chunk, count));
+    for(vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)it->join();
+}
+
 #endif
@@ -8,6 +8,20 @@
 
 #include "RanGenFile.h"
 #include "Graph.h"
+#include "Sampling.h"
+#include "StreamConverter.h"
+#include "Metrics.h"
+#include "OutputSink.h"
+#include "BinaryWriter.h"
+#include "BundleWriter.h"
+#include "Delta.h"
+#include "Emitter.h"
+#include "MipWriter.h"
+#include "Compression.h"
+#include "Subgraph.h"
+#include "Batch.h"
+#include "AsyncIO.h"
+#include "Manifest.h"
 #include "helper.h"
 
 #include <iostream>
@@ -19,11 +33,18 @@
 #include <string>
 #include <ctime>
 #include <cmath>
+#include <algorithm>
+#include <map>
 
 #include <cstring>
 
 #define MODE_CHECK 0x2
 #define MODE_REGULAR 0x4
+#define MODE_SAMPLE 0x8
+#define MODE_METRICS 0x10
+#define MODE_MERGE 0x20
+#define MODE_BATCH 0x40
+#define MODE_UPDATE 0x80
 
 // make life easier
 using namespace std;
@@ -31,7 +52,7 @@ using namespace std;
 string program_name;
 
 // program short options
-const char * const short_options = "hc:vgdt:";
+const char * const short_options = "hc:vgdt:s:j:S:H:CRrF:xM:KWBbV:Df:m:z:G:O:U:";
 // the programs options
 const struct option long_options[] = {
     {"help", 0, NULL, 'h'},
@@ -40,6 +61,28 @@ const struct option long_options[] = {
     {"graphml", 0, NULL, 'g'},
     {"dummy", 0, NULL, 'd'},
 	{ "timelimit", 1, NULL, 't' },
+    {"sample", 1, NULL, 's'},
+    {"threads", 1, NULL, 'j'},
+    {"seed", 1, NULL, 'S'},
+    {"target-horizon", 1, NULL, 'H'},
+    {"cpm", 0, NULL, 'C'},
+    {"check-resources", 0, NULL, 'R'},
+    {"flag-resources", 0, NULL, 'r'},
+    {"horizon-factor", 1, NULL, 'F'},
+    {"stream", 0, NULL, 'x'},
+    {"metrics", 1, NULL, 'M'},
+    {"compact", 0, NULL, 'K'},
+    {"windows", 0, NULL, 'W'},
+    {"binary", 0, NULL, 'B'},
+    {"bundle", 0, NULL, 'b'},
+    {"variants", 1, NULL, 'V'},
+    {"merge-delta", 0, NULL, 'D'},
+    {"formats", 1, NULL, 'f'},
+    {"model", 1, NULL, 'm'},
+    {"compress", 1, NULL, 'z'},
+    {"graphml-subgraph", 1, NULL, 'G'},
+    {"batch", 1, NULL, 'O'},
+    {"check-update", 1, NULL, 'U'},
     {NULL, 0, NULL, 0}
 };
 
@@ -49,6 +92,53 @@ const struct option long_options[] = {
 #define PATH_SEPARATOR "/"
 #endif
 
+// maximum number of attempts to hit a target horizon before giving up
+#define MAX_TARGET_ATTEMPTS 100000
+// maximum number of generations to obtain resource feasible windows, overloads caused by the network itself persist for any seed
+#define MAX_RESOURCE_ATTEMPTS 10
+// nodes per chunk if GraphML is formatted in parallel
+#define GRAPHML_CHUNK_NODES (1 << 13)
+
+/**
+ * @brief settings of a conversion as given via commandline
+ */
+class ConversionOptions {
+public:
+    bool            verbose;        /**< display additional messages */
+    bool            dummynodes;     /**< output dummy nodes at start and end */
+    bool            graphml;        /**< output additional graphml file to ofilename.graphml */
+    SubgraphSpec    subgraph;       /**< part of the network written to GraphML */
+    int             time_limit;     /**< controls the maximum deviation release and deadlines can have */
+    unsigned int    seed;           /**< seed of the time generation */
+    int             threads;        /**< number of threads to use */
+    int             target_lo;      /**< lower bound of target horizon band, only used if target_hi > 0 */
+    int             target_hi;      /**< upper bound of target horizon band, 0 to disable */
+    bool            cpm;            /**< output est, lst and critical path length */
+    bool            check_resources;/**< regenerate times until energetic reasoning finds no resource overload */
+    bool            flag_resources; /**< report resource overloads found by energetic reasoning without regenerating */
+    double          horizon_factor; /**< if >= 1, keep horizon within horizon_factor x critical path length */
+    bool            stream;         /**< convert in a single pass without building the graph */
+    bool            compact;        /**< write ranges, constant capacity profile and sparse demands */
+    bool            windows;        /**< write feasible periods of each activity and their total count */
+    bool            binary;         /**< write binary format (see BinaryFormat.h) instead of .dat */
+    bool            bundle;         /**< append output to a bundle (see BundleFormat.h) instead of writing single files */
+    vector<string>  formats;        /**< additional output formats (dzn, json), written to ofilename.<format> */
+    string          model;          /**< write time-indexed MIP model (lp, mps) instead of .dat, empty to disable */
+    map<string, CompressionMethod> compression; /**< compression per output (dat, graphml, dzn, json), missing outputs are not compressed */
+    AsyncIO        *io;             /**< I/O thread writing output files behind, NULL to write them directly */
+    BundleWriter   *bundle_writer;  /**< bundle shared by the instances of a batch, NULL to open the output file as bundle */
+    
+    /**
+     * @return compression of output (dat, graphml, dzn or json)
+     */
+    CompressionMethod compression_of(const string& output) const {
+        map<string, CompressionMethod>::const_iterator it = compression.find(output);
+        return it != compression.end() ? it->second : COMPRESSION_NONE;
+    }
+    
+    ConversionOptions() : verbose(false), dummynodes(false), graphml(false), time_limit(10), seed(0), threads(1), target_lo(0), target_hi(0), cpm(false), check_resources(false), flag_resources(false), horizon_factor(0.0), stream(false), compact(false), windows(false), binary(false), bundle(false), io(NULL), bundle_writer(NULL) {}
+};
+
 /**
  * @brief diplays help message
  * @details displays all short and long options of the converter. Note that the syntax to use the converter requires to specify first all options and two files (input, output) except if the check mode is used (-c file)
@@ -60,14 +150,45 @@ const struct option long_options[] = {
 // print usage function including detailed help for all opts
 void print_usage(FILE * stream, int exit_code) {
     
-    fprintf(stream, "usage: %s options [intputfile] [outputfile]", program_name.substr(program_name.rfind(PATH_SEPARATOR) + 1).c_str());
+    fprintf(stream, "usage: %s options [intputfile] [outputfile]\n", program_name.substr(program_name.rfind(PATH_SEPARATOR) + 1).c_str());
     fprintf(stream,
             "   -h --help                   display help message\n"
             "   -c --check-input filename   check if a given input file obeys the RanGen format\n"
             "   -v --verbose                perform in verbose mode\n"
             "   -g --graphml                output additionally GraphML file\n"
             "   -d --dummy                  output dummy nodes at start and end\n"
-			"   -t --timelimit  value       limit X, Y range. Higher values lead to more flexibility but a higher time horizon");
+			"   -t --timelimit  value       limit X, Y range. Higher values lead to more flexibility but a higher time horizon\n"
+            "   -s --sample n               dry run: generate times n times and print statistics of horizon and windows, no output is written\n"
+            "   -U --check-update n         dry run: apply n random changes of durations, paddings and relations to the generated times and\n"
+            "                               check their incremental update against a full recomputation, no output is written\n"
+            "   -j --threads n              number of threads to use (default: number of cores)\n"
+            "   -S --seed value             seed of the time generation, use to reproduce a previous run\n"
+            "   -H --target-horizon lo:hi   retry time generation in parallel with varying seeds and time limits until horizon lies in [lo, hi]\n"
+            "   -C --cpm                    output earliest/latest starts and critical path length of a critical path analysis\n"
+            "   -R --check-resources        screen windows for resource overloads (energetic reasoning) and regenerate until none is found,\n"
+            "                               gives up after 10 attempts\n"
+            "   -r --flag-resources         screen windows for resource overloads and report them, the instance is written regardless\n"
+            "   -F --horizon-factor f       horizon-minimising generation, keeps horizon within f >= 1 times the critical path length\n"
+            "   -x --stream                 convert in a single pass with bounded memory, requires successors to have higher ids than predecessors\n"
+            "   -K --compact                write compact output using ranges, one capacity vector plus horizon and sparse resource demands\n"
+            "   -W --windows                write the feasible periods release + 1..deadline of each activity and their total count for time-indexed models\n"
+            "   -B --binary                 write memory mappable binary format (see BinaryFormat.h) instead of .dat\n"
+            "   -b --bundle                 append output to the bundle outputfile (see BundleFormat.h), created if it does not exist\n"
+            "   -V --variants n             write n variants of the times in delta mode: shared data once to outputfile, variant i to outputfile.v<i>\n"
+            "   -D --merge-delta            reconstruct the full .dat file of the variant given as inputfile (written by -V) to outputfile\n"
+            "   -f --formats list           write additional formats (comma separated: dzn, json) to outputfile.<format> in the same pass\n"
+            "   -m --model format           write a time-indexed MIP model (lp or mps) of the instance with generated windows instead of .dat\n"
+            "   -G --graphml-subgraph spec  write only a subgraph to GraphML (implies -g), spec is one of hops:k:id,id,... (nodes within k edges\n"
+            "                               of the given GraphML node ids), levels:lo:hi (progressive levels lo..hi) or critical (critical path(s)\n"
+            "                               plus their predecessors and successors)\n"
+            "   -z --compress spec          compress outputs on the fly (gzip or zstd), either all via -z gzip or per output via e.g. -z graphml=zstd,dat=gzip\n"
+            "                               (outputs: dat, graphml, dzn, json), compressed files get the suffix .gz / .zst\n"
+            "   -M --metrics outputfile     compute network/resource metrics of all input files/directories, one CSV row (JSON line if outputfile ends in .json) per instance\n"
+            "   -O --batch directory        convert all input files/directories/glob patterns into directory on a work stealing pool of -j threads,\n"
+            "                               each instance uses seed + hash of its file name, failures are reported per file. Outputs whose input,\n"
+            "                               options and converter version are unchanged according to directory/" MANIFEST_NAME " are skipped\n"
+            "                               With -b, directory names the bundle all instances are appended to\n"
+            "   outputfile shm:/<name>      publish the instance in binary format as POSIX shared memory segment /<name> (see SharedMemory.h)\n");
     exit(exit_code);
 }
 
@@ -91,15 +212,26 @@ inline bool exists_file (const std::string& name) {
     }
 }
 
+/**
+ * @brief checks whether output goes to a POSIX shared memory segment
+ * 
+ * @param name outputfile as given on the commandline
+ * @return true if name is shm:<segment>
+ */
+inline bool shared_memory_target (const char *name) {
+    return strncmp(name, "shm:", 4) == 0;
+}
+
 /**
  * @brief helper func to check if file can be written
  * @details checks if program is exceuted with permission to write to disk. 
  * 
  * @param name path to check for writing permission
+ * @param append set to true to keep the contents of an existing file
  * @return true if converter could write to given path (name), false otherwise
  */
-inline bool writable_file (const std::string& name) {
-    ofstream f(name.c_str());
+inline bool writable_file (const std::string& name, const bool append = false) {
+    ofstream f(name.c_str(), append ? ios::app : ios::out);
     if (f.good()) {
         f.close();
         return true;
@@ -109,105 +241,266 @@ inline bool writable_file (const std::string& name) {
     }
 }
 
+/**
+ * @brief writes GraphML node elements of nodes [begin, end)
+ */
+static void graphml_nodes(RanGenFile& file, const int begin, const int end, OutputSink& ofs, const bool cpm) {
+    // keys of critical path analysis follow resource demands
+    int cpm_index = 4 + (int)file.resource_availability().size();
+    for(int i = begin; i < end; i++) {
+        ofs<<"<node id=\"n"<<i<<"\">"<<'\n';
+        ofs<<"<data key=\"d0\">"<<file.nodes(i).activity_duration<<"</data>"<<'\n'; //d0 = activity duration
+        ofs<<"<data key=\"d1\">"<<file.nodes(i).release<<"</data>"<<'\n'; //d1 = release
+        ofs<<"<data key=\"d2\">"<<file.nodes(i).deadline<<"</data>"<<'\n'; //d2 = deadline
+        ofs<<"<data key=\"d3\">"<<(file.nodes(i).deadline - file.nodes(i).release)<<"</data>"<<'\n'; //d3 = window
+        
+        // res_demands
+        if(!file.nodes(i).resource_requirements.empty()) {
+            int index = 4;
+            for(vector<int>::const_iterator jt = file.nodes(i).resource_requirements.begin(); jt != file.nodes(i).resource_requirements.end(); ++jt) {
+                ofs<<"<data key=\"d"<<index<<"\">"<<*jt<<"</data>"<<'\n';
+                index++;
+            }
+        }
+        if(cpm) {
+            ofs<<"<data key=\"d"<<cpm_index<<"\">"<<file.nodes(i).est<<"</data>"<<'\n';
+            ofs<<"<data key=\"d"<<(cpm_index + 1)<<"\">"<<file.nodes(i).lst<<"</data>"<<'\n';
+            ofs<<"<data key=\"d"<<(cpm_index + 2)<<"\">"<<(file.nodes(i).lst - file.nodes(i).est)<<"</data>"<<'\n';
+        }
+        ofs<<"</node>"<<'\n';
+    }
+}
+
+/**
+ * @return number of edges leaving node i written to GraphML
+ */
+static int graphml_edge_count(RanGenFile& file, const int i, const bool dummynodes) {
+    if(dummynodes)return (int)file.successors(i).size();
+    if(i == 0)return 0;
+    const vector<int>& succ = file.successors(i);
+    return (int)(succ.size() - count(succ.begin(), succ.end(), file.node_count() - 1));
+}
+
+/**
+ * @brief writes GraphML edge elements of the edges leaving nodes [begin, end), numbered starting with eid
+ */
+static void graphml_edges(RanGenFile& file, const int begin, const int end, int eid, OutputSink& ofs, const bool dummynodes) {
+    for(int i = begin; i < end; i++) {
+        if(!dummynodes && i == 0)continue; //dummynodes disabled, skip them!
+        const vector<int>& succ = file.successors(i);
+        for(vector<int>::const_iterator it = succ.begin(); it != succ.end(); ++it) {
+            if(!dummynodes && *it == file.node_count() - 1)continue;
+            ofs<<"<edge id=\"e"<<eid<<"\" source=\"n"<<i<<"\" target=\"n"<<*it<<"\" />"<<'\n';
+            eid++;
+        }
+    }
+}
+
 /**
  * @brief generates for given RanGenFile graphml output
- * @details generates for given RanGenFile graphml output for use i.e. in GePhi. GraphML output contains node and edge struture labeling nodes/edges n0, n1, .../ e0, e2, ... . Note that labels start only with 0 iff dummynodes are selected. Furthermore, duration, release, deadline and time between deadline and release are written to the GraphML file.
+ * @details generates for given RanGenFile graphml output for use i.e. in GePhi. GraphML output contains node and edge struture labeling nodes/edges n0, n1, .../ e0, e1, ... . Note that node labels start only with 0 iff dummynodes are selected, edge labels always start with 0. Furthermore, duration, release, deadline and time between deadline and release are written to the GraphML file.
  * 
  * 
  * @param verbose set to true if messages shall be displayed
  * @param file reference to RanGenFile for which contents shall be written to GraphML
- * @param ofilename path to file to write to
+ * @param ofs sink to write to
  * @param dummynodes set to true to output dummynodes at start and end of graph (default false)
+ * @param cpm set to true to output earliest/latest start and slack as computed by RanGenFile::critical_path (default false)
+ * @param threads number of threads to format node and edge elements with (default 1)
+ * @param subgraph ascending ids of the nodes to write along with the edges between them, NULL to write all nodes (default)
  * @return returns true if no errors occured
  */
-bool generate_graphml(const bool verbose, RanGenFile& file, const char *ofilename, const bool dummynodes = false) {
+bool generate_graphml(const bool verbose, RanGenFile& file, OutputSink& ofs, const bool dummynodes = false, const bool cpm = false, const int threads = 1,
+                      const vector<int> *subgraph = NULL) {
     
     int offset = dummynodes ? 0 : 1;
     
     if(verbose)cout<<"writing GraphML file..."<<endl;
-    // open output stream
-    ofstream ofs(ofilename);
-    
-    if(ofs.bad() || ofs.fail()) {
-        cout<<"error: output file could not been opened"<<endl;
-        exit(1);
-    }
     
     //print header
-    ofs<<"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"<<endl<<
+    ofs<<"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"<<'\n'<<
     "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\"" \
     " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"" \
     " xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns" \
-    "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">"<<endl;
+    "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">"<<'\n';
     
     // print attribute definition (for activity duration, release, deadline, window[deadline - release])
     // actually, window is redundant info, but included for convenience reasons...
-    ofs<<"<key id=\"d0\" for=\"node\" attr.name=\"activity_duration\" attr.type=\"int\">"<<endl;
-    ofs<<"<default>0</default>"<<endl;
-    ofs<<"</key>"<<endl;
-    ofs<<"<key id=\"d1\" for=\"node\" attr.name=\"release\" attr.type=\"int\">"<<endl;
-    ofs<<"<default>0</default>"<<endl;
-    ofs<<"</key>"<<endl;
-    ofs<<"<key id=\"d2\" for=\"node\" attr.name=\"deadline\" attr.type=\"int\">"<<endl;
-    ofs<<"<default>0</default>"<<endl;
-    ofs<<"</key>"<<endl;
-    ofs<<"<key id=\"d3\" for=\"node\" attr.name=\"window\" attr.type=\"int\">"<<endl;
-    ofs<<"<default>0</default>"<<endl;
-    ofs<<"</key>"<<endl;
+    ofs<<"<key id=\"d0\" for=\"node\" attr.name=\"activity_duration\" attr.type=\"int\">"<<'\n';
+    ofs<<"<default>0</default>"<<'\n';
+    ofs<<"</key>"<<'\n';
+    ofs<<"<key id=\"d1\" for=\"node\" attr.name=\"release\" attr.type=\"int\">"<<'\n';
+    ofs<<"<default>0</default>"<<'\n';
+    ofs<<"</key>"<<'\n';
+    ofs<<"<key id=\"d2\" for=\"node\" attr.name=\"deadline\" attr.type=\"int\">"<<'\n';
+    ofs<<"<default>0</default>"<<'\n';
+    ofs<<"</key>"<<'\n';
+    ofs<<"<key id=\"d3\" for=\"node\" attr.name=\"window\" attr.type=\"int\">"<<'\n';
+    ofs<<"<default>0</default>"<<'\n';
+    ofs<<"</key>"<<'\n';
     
     // after 4 initial data keys, include also resource demands of each node
     for(unsigned int i = 1; i <= file.resource_availability().size(); ++i) {
         unsigned int index = i + 3;
-        ofs<<"<key id=\"d"<<index<<"\" for=\"node\" attr.name=\"res"<<i<<"_demand\" attr.type=\"int\">"<<endl;
-        ofs<<"<default>0</default>"<<endl;
-        ofs<<"</key>"<<endl;
+        ofs<<"<key id=\"d"<<index<<"\" for=\"node\" attr.name=\"res"<<i<<"_demand\" attr.type=\"int\">"<<'\n';
+        ofs<<"<default>0</default>"<<'\n';
+        ofs<<"</key>"<<'\n';
+    }
+    
+    // keys of critical path analysis follow resource demands
+    int cpm_index = 4 + (int)file.resource_availability().size();
+    if(cpm) {
+        const char *names[] = {"est", "lst", "slack"};
+        for(int i = 0; i < 3; i++) {
+            ofs<<"<key id=\"d"<<(cpm_index + i)<<"\" for=\"node\" attr.name=\""<<names[i]<<"\" attr.type=\"int\">"<<'\n';
+            ofs<<"<default>0</default>"<<'\n';
+            ofs<<"</key>"<<'\n';
+        }
     }
     
     //begin with graph
-    ofs<<"<graph id=\"G\" edgedefault=\"directed\">"<<endl;
-    
-    // first, print nodes
-        int nid = offset;
-        for(int i = offset; i < file.node_count() - offset; i++) {
-            ofs<<"<node id=\"n"<<nid<<"\">"<<endl;
-            ofs<<"<data key=\"d0\">"<<file.nodes(i).activity_duration<<"</data>"<<endl; //d0 = activity duration
-            ofs<<"<data key=\"d1\">"<<file.nodes(i).release<<"</data>"<<endl; //d1 = release
-            ofs<<"<data key=\"d2\">"<<file.nodes(i).deadline<<"</data>"<<endl; //d2 = deadline
-            ofs<<"<data key=\"d3\">"<<(file.nodes(i).deadline - file.nodes(i).release)<<"</data>"<<endl; //d3 = window
-            
-            // res_demands
-            if(!file.nodes(i).resource_requirements.empty()) {
-                int index = 4;
-                for(vector<int>::const_iterator jt = file.nodes(i).resource_requirements.begin(); jt != file.nodes(i).resource_requirements.end(); ++jt) {
-                    ofs<<"<data key=\"d"<<index<<"\">"<<*jt<<"</data>"<<endl;
-                    index++;
-                }
+    ofs<<"<graph id=\"G\" edgedefault=\"directed\">"<<'\n';
+    
+    // first, print nodes, ids are the node indices
+    const int first = offset, count = file.node_count() - 2 * offset;
+    if(subgraph) {
+        // edge ids are dense within the subgraph
+        for(vector<int>::const_iterator it = subgraph->begin(); it != subgraph->end(); ++it)graphml_nodes(file, *it, *it + 1, ofs, cpm);
+        int eid = 0;
+        for(vector<int>::const_iterator it = subgraph->begin(); it != subgraph->end(); ++it) {
+            const vector<int>& succ = file.successors(*it);
+            for(vector<int>::const_iterator jt = succ.begin(); jt != succ.end(); ++jt) {
+                if(!binary_search(subgraph->begin(), subgraph->end(), *jt))continue;
+                ofs<<"<edge id=\"e"<<eid<<"\" source=\"n"<<*it<<"\" target=\"n"<<*jt<<"\" />"<<'\n';
+                eid++;
             }
-            ofs<<"</node>"<<endl;
-            nid++;
         }
+        if(verbose)cout<<subgraph->size()<<" nodes and "<<eid<<" edges of subgraph written..."<<endl;
+    }
+    else {
+        if(threads > 1 && count >= 2 * GRAPHML_CHUNK_NODES)
+            format_chunked(count, threads, GRAPHML_CHUNK_NODES, [&](long long begin, long long end, OutputSink& buffer) {
+                graphml_nodes(file, first + (int)begin, first + (int)end, buffer, cpm);
+            }, [&](long long /*begin*/, long long /*end*/, const OutputSink& buffer) {
+                ofs.write(buffer.data(), buffer.size());
+            });
+        else graphml_nodes(file, first, first + count, ofs, cpm);
+        
+        if(verbose)cout<<"nodes written..."<<endl;
+        
+        // progress with edges, ids are dense. Chunks cover the edges of a range of source nodes, hence start with the number of edges of all nodes before
+        if(threads > 1 && file.node_count() >= 2 * GRAPHML_CHUNK_NODES) {
+            vector<int> first_edge(file.node_count() + 1, 0);
+            for(int i = 0; i < file.node_count(); i++)first_edge[i + 1] = first_edge[i] + graphml_edge_count(file, i, dummynodes);
+            format_chunked(file.node_count(), threads, GRAPHML_CHUNK_NODES, [&](long long begin, long long end, OutputSink& buffer) {
+                graphml_edges(file, (int)begin, (int)end, first_edge[begin], buffer, dummynodes);
+            }, [&](long long /*begin*/, long long /*end*/, const OutputSink& buffer) {
+                ofs.write(buffer.data(), buffer.size());
+            });
+        }
+        else graphml_edges(file, 0, file.node_count(), 0, ofs, dummynodes);
+        
+        if(verbose)cout<<"edges written..."<<endl;
+    }
     
-    if(verbose)cout<<"nodes written..."<<endl;
+    //print footer
+    ofs<<"</graph>"<<'\n'<<"</graphml>"<<'\n';
     
-    // progress with edges
-        int eid = offset;
-        nid = offset;
-        for(int i = offset; i < file.node_count() - offset; ++i) {
-                for(int j = 0; j < file.node_count(); ++j) {
-                    if(!dummynodes && (j == 0 || j == file.node_count() - 1))
-                        continue; //dummynodes disabled, skip them!
-                    if(file.get(i, j))ofs<<"<edge id=\"e"<<eid<<"\" source=\"n"<<(nid)<<"\" target=\"n"<<j<<"\" />"<<endl;
-                    eid++;
-                }
-            nid++;
-        }
+    return ofs.good();
+}
+
+/**
+ * @brief writes instance with generated times in the .dat format used by the Kis / Alfieri models' implementations
+ * @details statements not depending on the generated times are requested via out.shared, all others via out.variant, hence the same writer produces regular .dat files and delta variants (see DeltaOutput).
+ * 
+ * @param opt settings of the conversion, controls dummy nodes and optional blocks
+ * @param file instance with generated times
+ * @param out sinks to write to
+ * @param cp_length critical path length, written if opt.cpm is set
+ * @return true if no errors occured
+ */
+bool write_dat(const ConversionOptions& opt, RanGenFile& file, DeltaOutput& out, const int cp_length) {
     
-    if(verbose)cout<<"edges written..."<<endl;
+    // file layout is
+//    time = {1,2,3,4,5,6,7};
+//    activity = {1,2,3};
+//    resource = {1,2};
+//    res_capacity = [[4,4],[4,4],[4,4],[4,4],[4,4],[4,4],[4,4]];
+//    maxProgress  = [0.5,0.5,0.5];
+//    minProgress  = [0,0,0];
+//    Relations = {<1,2>, <2,3>};
+//    release = [0,0,0];
+//    deadline = [4,5,7];
+//    res_demand = [[0,1],[1,1],[2,2]];
     
-    //print footer
-    ofs<<"</graph>"<<endl<<"</graphml>"<<endl;
+    DatEmitter dat(out, opt.compact);
+    vector<FormatEmitter *> emitters(1, &dat);
+    
+    return emit_instance(file, opt.dummynodes, opt.windows, opt.cpm, cp_length, emitters, opt.verbose, opt.threads);
+}
+
+/**
+ * @brief generates release/deadline windows and performs the optional analyses and checks
+ * @details runs are deterministic given seed and time limit. If resources are checked, times are regenerated with increasing seeds until no overload is found.
+ * 
+ * @param opt settings of the conversion
+ * @param file instance to generate the windows of
+ * @param seed seed of the first run, set to the seed of the accepted run
+ * @param time_limit controls the maximum deviation release and deadlines can have
+ * @param cp_length set to the critical path length if opt.cpm is set
+ * @return true if windows were generated, false if no resource feasible windows were found
+ */
+bool generate_windows(const ConversionOptions& opt, RanGenFile& file, unsigned int& seed, const int time_limit, int& cp_length) {
     
-    if(verbose)cout<<"GraphML file successfully written!"<<endl;
+    const bool verbose = opt.verbose;
+    
+    for(int attempt = 1; ; attempt++) {
+        // runs are deterministic given seed and time limit, i.e. this reproduces the winning run of the search
+        Random rnd(seed);
+        file.generate_times(time_limit, rnd, opt.horizon_factor);
+        
+        if(opt.cpm) {
+            cp_length = file.critical_path();
+            if(verbose)cout << "critical path length is " << cp_length << endl;
+        }
+        
+        if (verbose)cout << "times successfully generated!" << endl;
+        if (verbose)cout << "validating graph..." << endl;
+        
+        // check for failure of time generation procedure
+        if(!file.validate_times(true, opt.threads)) {
+            cout<<"error: validation of graph failed!"<<endl;
+            return false;
+        }
+        else if (verbose)cout << "graph successfully validated!" << endl;
+        
+        if(!opt.check_resources && !opt.flag_resources)break;
+        
+        // regenerated runs have to stay within the target band as well
+        int h = file.horizon();
+        bool in_band = opt.target_hi <= 0 || (opt.target_lo <= h && h <= opt.target_hi);
+        
+        vector<ResourceConflict> conflicts;
+        if(in_band && file.check_resources(conflicts, opt.threads)) {
+            if(verbose)cout << "resource check passed" << endl;
+            break;
+        }
+        
+        for(vector<ResourceConflict>::const_iterator it = conflicts.begin(); it != conflicts.end(); ++it)
+            cout<<"resource conflict: resource "<<(it->resource + 1)<<" overloaded on ["<<it->from<<", "<<it->to<<"), "
+            <<"required energy "<<it->energy<<" exceeds capacity "<<it->capacity<<" (seed "<<seed<<")"<<'\n';
+        
+        // flagged instances are written as generated
+        if(!opt.check_resources)break;
+        
+        if(attempt >= MAX_RESOURCE_ATTEMPTS) {
+            cout<<"error: no resource feasible windows found after "<<attempt<<" attempts"<<endl;
+            return false;
+        }
+        
+        seed++;
+        if(verbose)cout << "regenerating times using seed " << seed << endl;
+    }
     
     return true;
 }
@@ -216,20 +509,26 @@ bool generate_graphml(const bool verbose, RanGenFile& file, const char *ofilenam
  * @brief converts Patterson format to format as used in the formulation after Kis et al., Alfiere et al.
  * @details parses file in Patterson format first, generates then additional times and outputs then data in the structure used by the Kis / Alfieri models' implementations and if desired an additional GraphML file to investigate the network structure. Performs furthermore automatic checks whether given input is a DAG(directed acyclic graph).
  * 
- * @param verbose set to true to display additional messages
+ * If a target horizon band is given, time generation is retried in parallel with varying seeds and time limits until the horizon lies within the band. The seed and time limit of the winning run are reported.
+ * 
+ * @param opt settings of the conversion. time_limit controls the maximum deviation release and deadlines can have. Higher values lead to greater time horizon. Default is 10.
  * @param ifilename path to input file
  * @param ofilename path to output file
- * @param time_limit controls the maximum deviation release and deadlines can have. Higher values lead to greater time horizon. Default is 10. 
- * @param dummynodes set to true to ouput dummy nodes at start and end
- * @param graphml set to true to output additional graphml file to ofilename.graphml
+ * @param input contents of the input file if it was read before, NULL to read ifilename
  * @return true if no errors occured
  */
-bool generate_output(const bool verbose, const char *ifilename, const char *ofilename, const int time_limit, const bool dummynodes = false, const bool graphml = false) {
+bool generate_output(const ConversionOptions& opt, const char *ifilename, const char *ofilename, const string *input = NULL) {
     
+    const bool verbose = opt.verbose;
+    const bool dummynodes = opt.dummynodes;
+
     
     if(verbose)cout<<">>> get input >>>"<<endl;
     
-    RanGenFile file(ifilename);
+    // the batch pipeline reads inputs ahead
+    istringstream preloaded;
+    if(input)preloaded.str(*input);
+    RanGenFile file = input ? RanGenFile(preloaded, ifilename) : RanGenFile(ifilename);
     
     if(file.bad()) {
         cout<<"error while parsing "<<ifilename<<endl;
@@ -238,21 +537,6 @@ bool generate_output(const bool verbose, const char *ifilename, const char *ofil
     
     if(verbose)cout<<"parsed input file..."<<endl<<"<<< write output <<<"<<endl;
     
-    int activity_count = dummynodes ? file.node_count() : file.node_count() - 2;
-    
-    int offset = dummynodes ? 0 : 1; // used for iterating vectors
-    // file layout is
-//    time = {1,2,3,4,5,6,7};
-//    activity = {1,2,3};
-//    resource = {1,2};
-//    res_capacity = [[4,4],[4,4],[4,4],[4,4],[4,4],[4,4],[4,4]];
-//    maxProgress  = [0.5,0.5,0.5];
-//    minProgress  = [0,0,0];
-//    Relations = {<1,2>, <2,3>};
-//    release = [0,0,0];
-//    deadline = [4,5,7];
-//    res_demand = [[0,1],[1,1],[2,2]];
-    
     int maxtime = 0; // fill with maximum time to generate ascending time values
     
     // first of all generate for all nodes release and deadlines.
@@ -263,168 +547,543 @@ bool generate_output(const bool verbose, const char *ifilename, const char *ofil
 
 	if (verbose)cout << "generating times..." << endl;
 
-    file.generate_times(time_limit);
+    unsigned int seed = opt.seed;
+    int time_limit = opt.time_limit;
     
-	if (verbose)cout << "times successfully generated!" << endl;
-	if (verbose)cout << "validating graph..." << endl;
+    if(opt.target_hi > 0) {
+        HorizonSearchResult res;
+        if(!search_horizon(file, opt.target_lo, opt.target_hi, opt.time_limit, opt.horizon_factor, MAX_TARGET_ATTEMPTS, opt.threads, opt.seed, res)) {
+            cout<<"error: no horizon in ["<<opt.target_lo<<", "<<opt.target_hi<<"] found after "<<res.attempts<<" attempts"<<endl;
+            return false;
+        }
+        cout<<"target horizon met after "<<res.attempts<<" attempts: seed "<<res.seed<<", time limit "<<res.time_limit<<", horizon "<<res.horizon<<endl;
+        seed = res.seed;
+        time_limit = res.time_limit;
+    }
+    
+    if (verbose)cout << "using seed " << seed << ", time limit " << time_limit << endl;
     
-    // check for failure of time generation procedure
-	if(!file.validate_times()) {
-	cout<<"error: validation of graph failed!"<<endl;
-	exit(1);
-	}
-	else if (verbose)cout << "graph successfully validated!" << endl;
+    int cp_length = 0;
+    
+    if(!generate_windows(opt, file, seed, time_limit, cp_length))return false;
     
     // now get maxtime
      // set maxtime to ceil of latest deadline
-    int imaxtime = 0;
-    for(int i = 0; i < file.node_count(); i++)
-        {
-            // dmaxtime += it->deadline - it->release; // adding differences
-            imaxtime = ::max(imaxtime, file.nodes(i).deadline);
-        }
-	maxtime = imaxtime;
+	maxtime = file.horizon();
     
 	if(verbose)cout << "time horizon ist " << maxtime << " periods long" << endl;
-	assert(imaxtime > 0);
+	assert(maxtime > 0);
 
-    // open output file
-    ofstream ofs(ofilename);
+    // hand the instance to solvers on the same host without writing a file
+    if(shared_memory_target(ofilename)) {
+        if(!write_binary_shared(file, ofilename + 4, dummynodes, seed))return false;
+        if(verbose)cout<<"instance published as shared memory segment "<<(ofilename + 4)<<endl;
+        return true;
+    }
+    
+    // write output file, either on its own or appended to a bundle named after the input file.
+    // Entries of a bundle are formatted in memory, so that instances of a batch can be appended by several workers
+    BundleWriter own_bundle;
+    BundleWriter *bundle = opt.bundle_writer ? opt.bundle_writer : &own_bundle;
+    OutputSink single;
+    OutputSink graph;
+    OutputSink *ofs = &single;
+    string name = ifilename;
+    name = name.substr(name.find_last_of("/\\") + 1);
     
-    if(ofs.bad() || ofs.fail()) {
+    if(opt.bundle) {
+        if(!opt.bundle_writer && !own_bundle.open(ofilename)) {
+            cout<<"error: "<<ofilename<<" is not a bundle or could not be opened"<<endl;
+            return false;
+        }
+        single.open_memory();
+    }
+    else if(!single.open(compressed_name(ofilename, opt.compression_of("dat")).c_str(), opt.binary, false, opt.compression_of("dat"))) {
         cout<<"error: output file could not been opened"<<endl;
-        exit(1);
+        return false;
+    }
+    else if(opt.io)single.write_behind(opt.io);
+    
+    // additional formats are written to ofilename.<format> during the same traversal as the .dat file
+    DeltaOutput dat(*ofs);
+    DatEmitter dat_emitter(dat, opt.compact);
+    vector<FormatEmitter *> emitters;
+    vector<OutputSink *> format_sinks;
+    if(!opt.binary && opt.model.empty())emitters.push_back(&dat_emitter);
+    bool res = true;
+    for(vector<string>::const_iterator it = opt.formats.begin(); it != opt.formats.end(); ++it) {
+        string ffilename = compressed_name(string(ofilename) + "." + *it, opt.compression_of(*it));
+        format_sinks.push_back(new OutputSink());
+        if(!format_sinks.back()->open(ffilename.c_str(), false, false, opt.compression_of(*it))) {
+            cout<<"error: output file "<<ffilename<<" could not been opened"<<endl;
+            res = false;
+            break;
+        }
+        if(opt.io)format_sinks.back()->write_behind(opt.io);
+        emitters.push_back(create_emitter(*it, *format_sinks.back()));
+    }
+    
+    if(res && opt.binary)res = write_binary(file, *ofs, dummynodes);
+    if(res && !opt.model.empty())res = write_mip(file, *ofs, dummynodes, opt.model == "mps" ? MIP_MPS : MIP_LP);
+    if(res && !emitters.empty())res = emit_instance(file, dummynodes, opt.windows, opt.cpm, cp_length, emitters, verbose, opt.threads);
+    
+    if(!(opt.bundle ? single.good() : single.close()))res = false;
+    for(size_t i = 0; i < format_sinks.size(); i++) {
+        if(!format_sinks[i]->close())res = false;
+        delete format_sinks[i];
+    }
+    for(size_t i = opt.binary || !opt.model.empty() ? 0 : 1; i < emitters.size(); i++)delete emitters[i];
+    if(!res) {
+        cout<<"error: output file could not be written completely"<<endl;
+        return false;
+    }
+    if(verbose)cout<<"file successfully converted!"<<endl;
+    
+    // write graphml file if desired...
+    if(opt.graphml) {
+        vector<int> subgraph;
+        if(opt.subgraph.mode != SUBGRAPH_ALL && !opt.subgraph.select(file, dummynodes, subgraph)) {
+            cout<<"error: subgraph could not be determined"<<endl;
+            return false;
+        }
+        if(opt.bundle) {
+            graph.open_memory();
+            ofs = &graph;
+        }
+        else {
+            string gmlfilename = compressed_name(string(ofilename) + ".graphml", opt.compression_of("graphml"));
+            if(!single.open(gmlfilename.c_str(), false, false, opt.compression_of("graphml"))) {
+                cout<<"error: output file could not been opened"<<endl;
+                return false;
+            }
+            if(opt.io)single.write_behind(opt.io);
+        }
+        res = generate_graphml(verbose, file, *ofs, dummynodes, opt.cpm, opt.threads, opt.subgraph.mode != SUBGRAPH_ALL ? &subgraph : NULL);
+        if(!(opt.bundle ? graph.good() : single.close()) || !res) {
+            cout<<"error: GraphML file could not be written completely"<<endl;
+            return false;
+        }
+        if(verbose)cout<<"GraphML file successfully written!"<<endl;
+    }
+    
+    if(opt.bundle) {
+        InstanceMetrics metrics;
+        compute_metrics(file, opt.threads, metrics);
+        res = bundle->add(name, opt.binary ? RGC_BUNDLE_FORMAT_BINARY : RGC_BUNDLE_FORMAT_DAT, seed, single.data(), single.size(), metrics, maxtime);
+        if(res && opt.graphml)res = bundle->add(name + ".graphml", RGC_BUNDLE_FORMAT_GRAPHML, seed, graph.data(), graph.size(), metrics, maxtime);
+        if(!res || (!opt.bundle_writer && !own_bundle.close())) {
+            cout<<"error: bundle "<<ofilename<<" could not be written"<<endl;
+            return false;
+        }
+        if(verbose)cout<<"appended "<<name<<" to bundle "<<ofilename<<endl;
     }
+    
+    return true;
+}
 
-    // time
-    ofs<<"time = {";
-    for(int i = offset; i < maxtime; i++)ofs<<i<<",";
-    ofs<<maxtime<<"};"<<endl;
-    if(verbose)cout<<"time written..."<<endl;
+/**
+ * @brief converts one instance, either in streaming mode or via generate_output
+ * 
+ * @param opt settings of the conversion
+ * @param ifilename path to input file
+ * @param ofilename path to output file
+ * @param input contents of the input file if it was read before, NULL to read ifilename. Ignored in streaming mode.
+ * @return true if no errors occured
+ */
+bool convert_instance(const ConversionOptions& opt, const char *ifilename, const char *ofilename, const string *input = NULL) {
+    if(opt.stream) {
+        if(opt.verbose)cout<<"using seed "<<opt.seed<<", time limit "<<opt.time_limit<<endl;
+        StreamConverter converter(opt.time_limit, opt.horizon_factor, opt.seed, opt.dummynodes, opt.compact, opt.windows);
+        return converter.convert(ifilename, compressed_name(ofilename, opt.compression_of("dat")).c_str(), opt.verbose, opt.compression_of("dat"));
+    }
+    return generate_output(opt, ifilename, ofilename, input);
+}
+
+/**
+ * @brief writes several variants of release/deadline windows of one instance in delta mode
+ * @details statements which do not depend on the generated times are written once to ofilename, each variant v = 1..variants is written to ofilename.v<v> holding only its times and references to the base (see DeltaOutput). The first variant uses opt.seed, each further variant the seed following the one of its predecessor. merge_delta reconstructs the full .dat file of a variant, which is identical to the output of a regular run with the variant's seed.
+ * 
+ * @param opt settings of the conversion
+ * @param ifilename path to input file
+ * @param ofilename path of the base file
+ * @param variants number of variants to generate
+ * @return true if no errors occured
+ */
+bool variant_output(const ConversionOptions& opt, const char *ifilename, const char *ofilename, const int variants) {
     
-    // activity
-    ofs<<"activity = {";
-    for(int i = 1; i < activity_count; i++)ofs<<i<<",";
-    ofs<<activity_count<<"};"<<endl;
-    if(verbose)cout<<"activity written..."<<endl;
+    const bool verbose = opt.verbose;
     
-    // resource
-    ofs<<"resource = {";
-    for(int i = 1; i < file.resource_count(); i++)ofs<<i<<",";
-    ofs<<file.resource_count()<<"};"<<endl;
-    if(verbose)cout<<"resource written..."<<endl;
+    if(verbose)cout<<">>> get input >>>"<<endl;
+    
+    RanGenFile file(ifilename);
     
-    // (overall) resource capacity (constant)
-    ofs<<"res_capacity = [";
-    for(int i = 1; i < maxtime; i++) {
+    if(file.bad()) {
+        cout<<"error while parsing "<<ifilename<<endl;
+        return false;
+    }
+    
+    OutputSink base;
+    if(!base.open(ofilename)) {
+        cout<<"error: output file could not been opened"<<endl;
+        return false;
+    }
+    
+    // variants refer to the base by its name only, both are kept in the same directory
+    string basename = ofilename;
+    basename = basename.substr(basename.find_last_of("/\\") + 1);
+    
+    unsigned int seed = opt.seed;
+    for(int v = 1; v <= variants; v++, seed++) {
+        int cp_length = 0;
+        if(!generate_windows(opt, file, seed, opt.time_limit, cp_length))return false;
         
-        // print resource availability (is here constant) at time t
-        ofs<<"[";
-        for(unsigned int j = 0; j < file.resource_availability().size() - 1; j++) {
-            ofs<<file.resource_availability()[j]<<",";
-        }
-        ofs<<file.resource_availability()[file.resource_count() - 1]<<"]";
-        // end print resource availability
-        ofs<<",";
-    }
-    ofs<<"[";
-    for(unsigned int j = 0; j < file.resource_availability().size() - 1; j++) {
-        ofs<<file.resource_availability()[j]<<",";
-    }
-    ofs<<file.resource_availability()[file.resource_count() - 1]<<"]];"<<endl;
-    if(verbose)cout<<"res_capacity written..."<<endl;
-    
-    // max progress
-    // max progress is 1.0 / activity duration. Can be also something arbitrarily
-    // i.e. draw max progress as uniform random variable out of interval [0.2 1]
-    ofs<<"maxProgress  = [";
-    for(int i = offset; i < file.node_count() - offset; i++) {
-            ofs<<(1.0 / file.nodes(i).activity_duration + 0.000001); // change here for other max progress...
+        string vfilename = delta_variant_name(ofilename, v);
+        OutputSink ofs;
+        if(!ofs.open(vfilename.c_str())) {
+            cout<<"error: output file "<<vfilename<<" could not been opened"<<endl;
+            return false;
+        }
+        ofs<<"//! base "<<basename<<'\n'<<"//! seed "<<seed<<'\n';
         
-            if(i != file.node_count() - offset - 1)ofs<<",";
-        }
-    ofs<<"];"<<endl;
-    if(verbose)cout<<"maxProgress written..."<<endl;
-    
-    // min progress
-    float min_progress = 0.0; // constant
-    ofs<<"minProgress  = [";
-    for(int i = 1; i < activity_count; i++)ofs<<min_progress<<",";
-    ofs<<min_progress<<"];"<<endl;
-    if(verbose)cout<<"minProgress written..."<<endl;
-    
-    // print relations
-    ofs<<"Relations  = {";
-    // print dummy node if desired
-    if(dummynodes) {
-        for(int j = 0; j < file.node_count(); j++)
-                    if(file.get(0, j))ofs<<"<1,"<<(j + 1)<<">,";
-    }
-    int curid = dummynodes ? 2 : 1;
-    for(int i =  1; i < file.node_count(); i++) {
-        for(int j = 0; j < file.node_count(); j++) {
-            if(!dummynodes) {
-                if(j != file.node_count() - 1)  { // print only if not last node
-                    if(file.get(i, j)) {
-                        ofs<<"<"<<curid<<","<<j + 1<<">";
-                    if(curid != activity_count - 1)ofs<<",";
-                    }
-                }
-                
-                
-            }
-            else {
-                if(file.get(i, j)) {
-                    
-                ofs<<"<"<<curid<<","<<j + 1<<">";
-              if(curid != activity_count - 1)ofs<<",";
-                }
-            }
+        // shared statements are written along with the first variant only
+        DeltaOutput out(ofs, v == 1 ? &base : NULL);
+        bool res = write_dat(opt, file, out, cp_length);
+        if(!ofs.close() || !res || (v == 1 && !base.close())) {
+            cout<<"error: output file could not be written completely"<<endl;
+            return false;
         }
-        curid++;
+        if(verbose)cout<<"variant "<<v<<" written to "<<vfilename<<" (seed "<<seed<<", horizon "<<file.horizon()<<")"<<endl;
     }
-    ofs<<"};"<<endl;
-    if(verbose)cout<<"Relations written..."<<endl;
     
-    // release
-    ofs<<"release  = [";
-        for(int i = offset; i < file.node_count() - offset; ++i) {
-            ofs<<file.nodes(i).release; // change here for other max progress...
-            if(i != file.node_count() - offset - 1)ofs<<",";
+    return true;
+}
+
+/**
+ * @brief performs a dry run of the time generation and prints statistics
+ * @details parses the input file and runs the time generation samples times in parallel. Percentiles of the time horizon and of the window widths (deadline - release) as well as the rate of failed validations are printed. No output file is written.
+ * 
+ * @param opt settings of the conversion, dummynodes controls whether dummy nodes enter the window statistics
+ * @param ifilename path to input file
+ * @param samples number of samples to draw
+ * @return true if no errors occured
+ */
+bool sample_output(const ConversionOptions& opt, const char *ifilename, const int samples) {
+    
+    const bool verbose = opt.verbose;
+    
+    if(verbose)cout<<">>> get input >>>"<<endl;
+    
+    RanGenFile file(ifilename);
+    
+    if(file.bad()) {
+        cout<<"error while parsing "<<ifilename<<endl;
+        return false;
+    }
+    
+    if(verbose)cout<<"sampling times using "<<opt.threads<<" threads, base seed "<<opt.seed<<"..."<<endl;
+    
+    SampleStatistics stats;
+    if(!sample_times(file, opt.time_limit, opt.horizon_factor, samples, opt.threads, opt.seed, opt.dummynodes, stats)) {
+        cout<<"error: sampling failed"<<endl;
+        return false;
+    }
+    
+    stats.print(stdout);
+    
+    return true;
+}
+
+/**
+ * @brief checks the incremental update of generated times against a full recomputation
+ * @details parses the input file, generates times and applies edits random changes, see RanGenFile::check_update_times. No output file is written.
+ * 
+ * @param opt settings of the conversion
+ * @param ifilename path to input file
+ * @param edits number of changes to apply
+ * @return true if all updates matched the full recomputation
+ */
+bool check_update_output(const ConversionOptions& opt, const char *ifilename, const int edits) {
+    
+    const bool verbose = opt.verbose;
+    
+    if(verbose)cout<<">>> get input >>>"<<endl;
+    
+    RanGenFile file(ifilename);
+    
+    if(file.bad()) {
+        cout<<"error while parsing "<<ifilename<<endl;
+        return false;
+    }
+    
+    Random rnd(opt.seed);
+    file.generate_times(opt.time_limit, rnd, opt.horizon_factor);
+    
+    if(!file.check_update_times(edits, opt.time_limit, rnd, verbose))return false;
+    
+    cout<<"incremental update matches full recomputation"<<endl;
+    return true;
+}
+
+/**
+ * @brief computes instance metrics of a corpus and writes them as CSV or JSON Lines
+ * @details directories are expanded to the .rcp files they contain. Instances are analysed in parallel, rows are written in the order the instances were listed. Instances which could not be analysed are reported and skipped.
+ * 
+ * @param opt settings of the conversion, only verbose and threads are used
+ * @param paths input files and directories
+ * @param ofilename path to output file, JSON Lines are written if it ends in .json, CSV otherwise
+ * @return true if all instances could be analysed
+ */
+bool metrics_output(const ConversionOptions& opt, const vector<string>& paths, const char *ofilename) {
+    
+    const bool verbose = opt.verbose;
+    
+    vector<string> files;
+    for(vector<string>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+        if(!list_instances(*it, files)) {
+            cout<<"error: "<<*it<<" is neither a file nor a readable directory"<<endl;
+            return false;
         }
-    ofs<<"];"<<endl;
-    if(verbose)cout<<"release written..."<<endl;
+    }
+    
+    if(verbose)cout<<"computing metrics of "<<files.size()<<" instances using "<<opt.threads<<" threads..."<<endl;
+    
+    vector<InstanceMetrics> metrics;
+    bool res = corpus_metrics(files, opt.threads, metrics);
+    
+    string name = ofilename;
+    bool json = name.size() >= 5 && name.substr(name.size() - 5) == ".json";
     
-    // deadline
-    ofs<<"deadline  = [";
-    for(int i = offset; i < file.node_count() - offset; ++i) {
-        ofs<<file.nodes(i).deadline; // change here for other max progress...
-        if(i != file.node_count() - offset - 1)ofs<<",";
+    OutputSink ofile;
+    if(!ofile.open(ofilename)) {
+        cout<<"error: output file could not be written to disc"<<endl;
+        return false;
     }
-    ofs<<"];"<<endl;
-    if(verbose)cout<<"deadline written..."<<endl;
     
-    // res_demand
-    ofs<<"res_demand = [";
-    for(int i = offset; i < file.node_count() - offset; ++i) {
-        // go through all resources and print activity's demand out!
-        ofs<<"[";
-        if(!file.nodes(i).resource_requirements.empty())
-            for(vector<int>::const_iterator jt = file.nodes(i).resource_requirements.begin(); jt != file.nodes(i).resource_requirements.end(); ++jt) {
-                ofs<<*jt;
-                if(jt != file.nodes(i).resource_requirements.end() - 1)ofs<<",";
-            }
-        ofs<<"]";
-        if(i != file.node_count() - offset - 1)ofs<<",";
+    if(!json)InstanceMetrics::print_csv_header(ofile);
+    for(vector<InstanceMetrics>::const_iterator it = metrics.begin(); it != metrics.end(); ++it) {
+        if(!it->ok) {
+            cout<<"error: could not compute metrics of "<<it->instance<<endl;
+            continue;
+        }
+        if(json)it->print_json(ofile);
+        else it->print_csv(ofile);
+    }
+    if(!ofile.close()) {
+        cout<<"error: output file could not be written completely"<<endl;
+        return false;
     }
-    ofs<<"];"<<endl;
-    if(verbose)cout<<"res_demand written..."<<endl;
-    if(verbose)cout<<"file successfully converted!"<<endl;
     
-    // write graphml file if desired...
-    if(graphml) {
-        string gmlfilename = string(ofilename) + ".graphml";
-       generate_graphml(verbose, file, gmlfilename.c_str(), dummynodes);
+    if(verbose)cout<<"metrics written to "<<ofilename<<endl;
+    
+    return res;
+}
+
+/**
+ * @brief describes all options which affect the output of a conversion, as recorded in the manifest of a batch
+ */
+string conversion_parameters(const ConversionOptions& opt) {
+    
+    ostringstream ss;
+    ss.precision(17);
+    ss<<"t="<<opt.time_limit<<" d="<<opt.dummynodes<<" S="<<opt.seed<<" F="<<opt.horizon_factor<<" H="<<opt.target_lo<<":"<<opt.target_hi;
+    ss<<" C="<<opt.cpm<<" R="<<opt.check_resources<<" x="<<opt.stream<<" K="<<opt.compact<<" W="<<opt.windows
+      <<" B="<<opt.binary<<" m="<<opt.model<<" g="<<opt.graphml;
+    if(opt.subgraph.mode != SUBGRAPH_ALL) {
+        ss<<" G="<<opt.subgraph.mode<<":"<<opt.subgraph.hops<<":"<<opt.subgraph.lo<<":"<<opt.subgraph.hi<<":";
+        for(size_t i = 0; i < opt.subgraph.centers.size(); i++)ss<<(i > 0 ? "," : "")<<opt.subgraph.centers[i];
+    }
+    vector<string> formats = opt.formats;
+    sort(formats.begin(), formats.end());
+    ss<<" f=";
+    for(size_t i = 0; i < formats.size(); i++)ss<<(i > 0 ? "," : "")<<formats[i];
+    ss<<" z=";
+    bool first = true;
+    for(map<string, CompressionMethod>::const_iterator it = opt.compression.begin(); it != opt.compression.end(); ++it) {
+        if(it->second == COMPRESSION_NONE)continue;
+        ss<<(first ? "" : ",")<<it->first<<":"<<it->second;
+        first = false;
+    }
+    return ss.str();
+}
+
+/**
+ * @return true if all files a conversion writes to output exist
+ */
+bool outputs_exist(const ConversionOptions& opt, const string& output) {
+    
+    if(!exists_file(compressed_name(output, opt.compression_of("dat"))))return false;
+    if(opt.graphml && !exists_file(compressed_name(output + ".graphml", opt.compression_of("graphml"))))return false;
+    for(vector<string>::const_iterator it = opt.formats.begin(); it != opt.formats.end(); ++it)
+        if(!exists_file(compressed_name(output + "." + *it, opt.compression_of(*it))))return false;
+    return true;
+}
+
+/**
+ * @brief converts many instances into one directory
+ * @details inputs are files, directories (their .rcp files) or glob patterns. The instances are converted on a work stealing pool of opt.threads workers, each instance using a single thread unless it is the only one. Unless in streaming mode, an I/O thread (io_uring if available) reads inputs ahead and writes outputs behind, so I/O and conversion overlap (see run_batch). Each instance uses opt.seed plus a hash of its file name and is written to directory/<name of instance><extension>, where the extension follows the output format. A failing instance is reported and does not stop the others.
+ * 
+ * The manifest of directory records for each output the hash of its input, the options and the converter version it was generated with. Outputs for which all of them are unchanged and whose files exist are skipped, hence a rerun only converts new or modified instances. If no seed was given, the base seed of the manifest is reused.
+ * 
+ * With opt.bundle set, all instances are appended to the bundle directory instead, which is locked for the whole run and receives a single index at its end. Workers format their instance in memory and append it once it is complete. Bundles keep every instance added, hence no manifest is used and a rerun appends all instances again.
+ * 
+ * @param opt settings of the conversion
+ * @param paths input files, directories or glob patterns
+ * @param directory existing output directory, path of the bundle if opt.bundle is set
+ * @param seed_given false if opt.seed was drawn at random, i.e. the base seed of the manifest is used instead
+ * @return true if all instances were converted or up to date
+ */
+bool batch_output(const ConversionOptions& opt, const vector<string>& paths, const char *directory, const bool seed_given) {
+    
+    vector<string> files;
+    for(vector<string>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+        if(!expand_instances(*it, files)) {
+            cout<<"error: "<<*it<<" matches no file or readable directory"<<endl;
+            return false;
+        }
+    }
+    
+    Manifest manifest;
+    BundleWriter bundle;
+    unsigned int seed = opt.seed;
+    if(opt.bundle) {
+        if(!bundle.open(directory)) {
+            cout<<"error: "<<directory<<" is not a bundle or could not be opened"<<endl;
+            return false;
+        }
+    }
+    else {
+        if(!manifest.load(directory)) {
+            cout<<"error: manifest of "<<directory<<" could not be read"<<endl;
+            return false;
+        }
+        if(!seed_given && manifest.has_seed())seed = manifest.seed();
+        if(!manifest.begin(seed)) {
+            cout<<"error: manifest of "<<directory<<" could not be written"<<endl;
+            return false;
+        }
+    }
+    
+    string extension = opt.binary ? ".bin" : !opt.model.empty() ? "." + opt.model : ".dat";
+    vector<BatchResult> results;
+    if(!batch_outputs(files, directory, extension, seed, results))return false;
+    if(opt.bundle)for(vector<BatchResult>::iterator it = results.begin(); it != results.end(); ++it)it->output = directory;
+    
+    if(opt.verbose && opt.bundle)cout<<"converting "<<files.size()<<" instances using "<<opt.threads<<" threads, base seed "<<seed<<", "<<bundle.count()<<" instances in bundle..."<<endl;
+    else if(opt.verbose)cout<<"converting "<<files.size()<<" instances using "<<opt.threads<<" threads, base seed "<<seed<<", "<<manifest.size()<<" outputs in manifest..."<<endl;
+    
+    // streaming mode reads and writes in bounded memory by itself
+    AsyncIO io;
+    if(!opt.stream) {
+        io.start();
+        if(opt.verbose)cout<<"reading and writing files via "<<io.backend()<<endl;
+    }
+    
+    // messages of concurrent conversions would interleave, hence only the result of each instance is printed
+    ConversionOptions single = opt;
+    single.verbose = false;
+    single.threads = files.size() == 1 ? opt.threads : 1;
+    single.io = opt.stream ? NULL : &io;
+    single.bundle_writer = opt.bundle ? &bundle : NULL;
+    run_batch(results, opt.threads, single.io, [&single, &manifest](BatchResult& r, const string *input) {
+        ConversionOptions o = single;
+        o.seed = r.seed;
+        if(o.bundle)return convert_instance(o, r.input.c_str(), r.output.c_str(), input);
+        
+        // streaming mode reads the instance by itself, hence it is read once more to be hashed
+        string contents;
+        if(!input && !read_file(r.input, contents)) {
+            cout<<"error: "<<r.input<<" could not be read"<<endl;
+            return false;
+        }
+        const string& data = input ? *input : contents;
+        const string name = r.output.substr(r.output.find_last_of("/\\") + 1);
+        ManifestEntry entry(content_hash(data.data(), data.size()), RANGENCONV_VERSION, conversion_parameters(o));
+        if(manifest.unchanged(name, entry) && outputs_exist(o, r.output)) {
+            r.skipped = true;
+            return true;
+        }
+        
+        // outputs are incomplete until the conversion finished
+        manifest.remove(name);
+        if(!convert_instance(o, r.input.c_str(), r.output.c_str(), input))return false;
+        manifest.record(name, entry);
+        return true;
+    });
+    io.stop();
+    
+    bool res = true;
+    if(opt.bundle && !bundle.close()) {
+        cout<<"error: index of bundle "<<directory<<" could not be written"<<endl;
+        res = false;
+    }
+    else if(!opt.bundle && !manifest.close()) {
+        cout<<"error: manifest of "<<directory<<" could not be written"<<endl;
+        res = false;
+    }
+    
+    int failures = 0, skipped = 0;
+    for(vector<BatchResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+        if(!it->ok)failures++;
+        if(it->skipped)skipped++;
+    }
+    cout<<(results.size() - failures)<<" of "<<results.size()<<" instances converted ("<<skipped<<" unchanged)";
+    if(failures > 0) {
+        cout<<", failed:"<<endl;
+        for(vector<BatchResult>::const_iterator it = results.begin(); it != results.end(); ++it)
+            if(!it->ok)cout<<"  "<<it->input<<(it->error.empty() ? "" : ": " + it->error)<<endl;
+    }
+    else cout<<endl;
+    
+    return failures == 0 && res;
+}
+
+/**
+ * @brief checks options for combinations which cannot be written
+ * 
+ * @param opt settings of the conversion
+ * @param variants number of variants (-V), 0 if disabled
+ * @return false if options conflict, an error is printed
+ */
+bool compatible_options(const ConversionOptions& opt, const int variants) {
+    
+    // binary format holds the instance data only, options altering the .dat layout do not apply
+    if(opt.binary && (opt.stream || opt.compact || opt.windows || opt.cpm)) {
+        cout<<"error: binary output cannot be combined with -x, -K, -W or -C"<<endl;
+        return false;
+    }
+    
+    // the model replaces the .dat file, options altering its layout do not apply
+    if(!opt.model.empty() && (opt.binary || opt.bundle || opt.stream || opt.compact || opt.windows || opt.cpm)) {
+        cout<<"error: model output cannot be combined with -B, -b, -x, -K, -W or -C"<<endl;
+        return false;
+    }
+    
+    // entries of bundles and delta variants are read back by offset, hence have to be plain
+    if(!opt.compression.empty() && (opt.bundle || variants > 0)) {
+        cout<<"error: compression cannot be combined with -b or -V"<<endl;
+        return false;
+    }
+    
+    // a bundle is written one file after another, while formats are written simultaneously
+    if(opt.bundle && !opt.formats.empty()) {
+        cout<<"error: additional formats cannot be written to a bundle"<<endl;
+        return false;
+    }
+    
+    // variants share one .dat base, other outputs hold the times throughout
+    if(variants > 0 && (opt.stream || opt.binary || opt.bundle || opt.graphml || opt.target_hi > 0 || !opt.formats.empty() || !opt.model.empty())) {
+        cout<<"error: variants cannot be combined with -x, -B, -b, -g, -H, -f or -m"<<endl;
+        return false;
+    }
+    
+    // streaming mode never builds the graph, hence supports no graph based features
+    if(opt.stream && (opt.bundle || !opt.formats.empty())) {
+        cout<<"error: streaming mode cannot be combined with -b or -f"<<endl;
+        return false;
+    }
+    if(opt.stream && (opt.graphml || opt.cpm || opt.check_resources || opt.flag_resources || opt.target_hi > 0)) {
+        cout<<"error: streaming mode cannot be combined with -g, -C, -R, -r or -H"<<endl;
+        return false;
     }
     
     return true;
@@ -441,17 +1100,21 @@ bool generate_output(const bool verbose, const char *ifilename, const char *ofil
  */
 int main(int argc, char * argv[]) {
     
-    bool verbose = false;       // indicate if program is in verbose mode or not
-    bool dummynodes = false;    // indicate if dummynodes shall be added to output
-    bool graphml = false;       // indicate if additional graphml file should be generated
+    ConversionOptions opt;      // verbose, dummynodes, graphml, time limit, ...
+    bool seed_given = false;
     
     program_name = argv[0];     // program name is stored as first argument
     int mode = 0;
     char *file_to_check = NULL;
     char *ifile = NULL;
     char *ofile = NULL;
+    char *metrics_file = NULL;
+    char *batch_directory = NULL;
     
-	int time_limit = 10; // value of 10 per default
+    int samples = 0;
+    int edits = 0;
+    int variants = 0;
+    opt.threads = (int)default_thread_count();
 	int options_used = 1; // one for program name
     int next_option = 0;
     
@@ -476,24 +1139,195 @@ int main(int argc, char * argv[]) {
                 break;
                 
                 case 'v':
-                verbose = true;
+                opt.verbose = true;
                 options_used++;
                 break;
                 
                 case 'd':
-                dummynodes = true;
+                opt.dummynodes = true;
                 options_used++;
                 break;
                 
                 case 'g':
-                graphml = true;
+                opt.graphml = true;
                 options_used++;
                 break;
                 
 				case 't':
-				time_limit = atoi(optarg); // use better c++11 for string conversion in a later deployment
+				opt.time_limit = atoi(optarg); // use better c++11 for string conversion in a later deployment
 				options_used += 2;
 				break;
+                
+                case 's':
+                samples = atoi(optarg);
+                mode |= MODE_SAMPLE;
+                options_used += 2;
+                break;
+                
+                case 'U':
+                edits = atoi(optarg);
+                mode |= MODE_UPDATE;
+                options_used += 2;
+                break;
+                
+                case 'j':
+                opt.threads = max(atoi(optarg), 1);
+                options_used += 2;
+                break;
+                
+                case 'S':
+                opt.seed = (unsigned int)strtoul(optarg, NULL, 10);
+                seed_given = true;
+                options_used += 2;
+                break;
+                
+                case 'C':
+                opt.cpm = true;
+                options_used++;
+                break;
+                
+                case 'R':
+                opt.check_resources = true;
+                options_used++;
+                break;
+                
+                case 'r':
+                opt.flag_resources = true;
+                options_used++;
+                break;
+                
+                case 'x':
+                opt.stream = true;
+                options_used++;
+                break;
+                
+                case 'K':
+                opt.compact = true;
+                options_used++;
+                break;
+                
+                case 'W':
+                opt.windows = true;
+                options_used++;
+                break;
+                
+                case 'B':
+                opt.binary = true;
+                options_used++;
+                break;
+                
+                case 'b':
+                opt.bundle = true;
+                options_used++;
+                break;
+                
+                case 'V':
+                variants = atoi(optarg);
+                if(variants <= 0) {
+                    cout<<"error: number of variants has to be positive"<<endl;
+                    exit(1);
+                }
+                options_used += 2;
+                break;
+                
+                case 'D':
+                mode |= MODE_MERGE;
+                options_used++;
+                break;
+                
+                case 'f':
+                {
+                    stringstream list(optarg);
+                    string format;
+                    while(getline(list, format, ',')) {
+                        if(format != "dzn" && format != "json") {
+                            cout<<"error: unknown output format "<<format<<", supported are dzn and json"<<endl;
+                            exit(1);
+                        }
+                        if(find(opt.formats.begin(), opt.formats.end(), format) == opt.formats.end())opt.formats.push_back(format);
+                    }
+                }
+                options_used += 2;
+                break;
+                
+                case 'm':
+                opt.model = optarg;
+                if(opt.model != "lp" && opt.model != "mps") {
+                    cout<<"error: unknown model format "<<opt.model<<", supported are lp and mps"<<endl;
+                    exit(1);
+                }
+                options_used += 2;
+                break;
+                
+                case 'G':
+                if(!opt.subgraph.parse(optarg)) {
+                    cout<<"error: subgraph has to be given as hops:k:id,id,..., levels:lo:hi or critical"<<endl;
+                    exit(1);
+                }
+                opt.graphml = true;
+                options_used += 2;
+                break;
+                
+                case 'z':
+                {
+                    // either one method for all outputs or a list of output=method
+                    stringstream list(optarg);
+                    string item;
+                    while(getline(list, item, ',')) {
+                        size_t eq = item.find('=');
+                        CompressionMethod method;
+                        if(!parse_compression(item.substr(eq == string::npos ? 0 : eq + 1), method)) {
+                            cout<<"error: unknown compression "<<item<<", supported are gzip, zstd and none"<<endl;
+                            exit(1);
+                        }
+                        if(!compression_available(method)) {
+                            cout<<"error: "<<item<<" compression is not available in this build"<<endl;
+                            exit(1);
+                        }
+                        const char *outputs[] = {"dat", "graphml", "dzn", "json"};
+                        bool found = false;
+                        for(int i = 0; i < 4; i++)
+                            if(eq == string::npos || item.substr(0, eq) == outputs[i]) {
+                                opt.compression[outputs[i]] = method;
+                                found = true;
+                            }
+                        if(!found) {
+                            cout<<"error: unknown output "<<item.substr(0, eq)<<", outputs are dat, graphml, dzn and json"<<endl;
+                            exit(1);
+                        }
+                    }
+                }
+                options_used += 2;
+                break;
+                
+                case 'O':
+                batch_directory = optarg;
+                mode |= MODE_BATCH;
+                options_used += 2;
+                break;
+                
+                case 'M':
+                metrics_file = optarg;
+                mode |= MODE_METRICS;
+                options_used += 2;
+                break;
+                
+                case 'F':
+                opt.horizon_factor = atof(optarg);
+                if(opt.horizon_factor < 1.0) {
+                    cout<<"error: horizon factor has to be at least 1"<<endl;
+                    exit(1);
+                }
+                options_used += 2;
+                break;
+                
+                case 'H':
+                if(sscanf(optarg, "%d:%d", &opt.target_lo, &opt.target_hi) != 2 || opt.target_lo > opt.target_hi || opt.target_hi <= 0) {
+                    cout<<"error: target horizon has to be given as lo:hi with 0 < hi and lo <= hi"<<endl;
+                    exit(1);
+                }
+                options_used += 2;
+                break;
 
                 case '?':
                 // user specified invalid options, terminate with exit code 1
@@ -510,6 +1344,85 @@ int main(int argc, char * argv[]) {
         }
     } while(next_option != -1);
     
+    // draw seed if user did not specify one, so every run can be reproduced via -S
+    if(!seed_given)opt.seed = (unsigned int)rand();
+    
+    if(mode & MODE_BATCH) {
+        // all remaining arguments are input files, directories or glob patterns
+        if(optind >= argc) {
+            cout<<"error: batch mode requires at least one input file, directory or pattern"<<endl;
+            exit(1);
+        }
+        // with -b, all instances are appended to the bundle given instead of the directory
+        if(!opt.bundle && !is_directory(batch_directory)) {
+            cout<<"error: output directory "<<batch_directory<<" does not exist"<<endl;
+            exit(1);
+        }
+        if(opt.bundle && is_directory(batch_directory)) {
+            cout<<"error: -b requires the bundle file instead of a directory for -O"<<endl;
+            exit(1);
+        }
+        if(variants > 0 || mode != MODE_BATCH) {
+            cout<<"error: batch mode cannot be combined with -V, -c, -s, -D or -M"<<endl;
+            exit(1);
+        }
+        if(!compatible_options(opt, variants))exit(1);
+        vector<string> paths(argv + optind, argv + argc);
+        return batch_output(opt, paths, batch_directory, seed_given) ? 0 : 1;
+    }
+    
+    if(mode & MODE_METRICS) {
+        // all remaining arguments are input files or directories
+        if(optind >= argc) {
+            cout<<"error: metrics mode requires at least one input file or directory"<<endl;
+            exit(1);
+        }
+        vector<string> paths(argv + optind, argv + argc);
+        return metrics_output(opt, paths, metrics_file) ? 0 : 1;
+    }
+    
+    
+    if(mode & MODE_SAMPLE) {
+        // dry run needs only an input file
+        if(argc - options_used != 1) {
+            cout<<"error: sample mode requires exactly one input file"<<endl;
+            exit(1);
+        }
+        if(samples <= 0) {
+            cout<<"error: number of samples has to be positive"<<endl;
+            exit(1);
+        }
+        if(!exists_file(argv[argc - 1])) {
+            cout<<"error: input file not found / cannot be opened"<<endl;
+            exit(1);
+        }
+        return sample_output(opt, argv[argc - 1], samples) ? 0 : 1;
+    }
+    
+    if(mode & MODE_UPDATE) {
+        if(argc - options_used != 1) {
+            cout<<"error: update check requires exactly one input file"<<endl;
+            exit(1);
+        }
+        if(edits <= 0) {
+            cout<<"error: number of changes has to be positive"<<endl;
+            exit(1);
+        }
+        if(!exists_file(argv[argc - 1])) {
+            cout<<"error: input file not found / cannot be opened"<<endl;
+            exit(1);
+        }
+        return check_update_output(opt, argv[argc - 1], edits) ? 0 : 1;
+    }
+    
+    if(mode & MODE_MERGE) {
+        if(argc - options_used != 2) {
+            cout<<"error: merge mode requires a variant and an output file"<<endl;
+            exit(1);
+        }
+        return merge_delta(argv[argc - 2], argv[argc - 1]) ? 0 : 1;
+    }
+    
     // check if there is enough arguments left for input / output files
     if(argc - options_used == 1) {
         cout<<"error: outputfile not specified"<<endl;
@@ -533,19 +1446,31 @@ int main(int argc, char * argv[]) {
             cout<<"error: input file not found / cannot be opened"<<endl;
             exit(1);
         }
-        if(!writable_file(ofile)) {
+        if(shared_memory_target(ofile)) {
+            // the segment holds the binary instance only
+            if(ofile[4] != '/' || strchr(ofile + 5, '/') || opt.stream || opt.bundle || variants > 0 || opt.graphml || !opt.formats.empty() || !opt.model.empty() ||
+               !opt.compression.empty() || opt.compact || opt.windows || opt.cpm) {
+                cout<<"error: shared memory output requires a name shm:/<name> and cannot be combined with -x, -b, -V, -g, -f, -m, -z, -K, -W or -C"<<endl;
+                exit(1);
+            }
+        }
+        else if(!writable_file(compressed_name(ofile, opt.compression_of("dat")).c_str(), opt.bundle)) {
             cout<<"error: output file could not be written to disc"<<endl;
             exit(1);
         }
         
+        if(!compatible_options(opt, variants))exit(1);
+        
+        if(variants > 0)return variant_output(opt, ifile, ofile, variants) ? 0 : 1;
+        
         // now perform output
-        if(ifile && ofile)generate_output(verbose, ifile, ofile, time_limit, dummynodes, graphml);
+        if(ifile && ofile && !convert_instance(opt, ifile, ofile))exit(1);
     }
     
     if(mode & MODE_CHECK) {
         assert(file_to_check);
         RanGenFile file(file_to_check);
-        if(file.validate_file(verbose))
+        if(file.validate_file(opt.verbose))
             cout<<"file ok"<<endl;
         else
             cout<<"file bad"<<endl;